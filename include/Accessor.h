@@ -23,6 +23,7 @@
 #include "WorkerPool.h"
 #include "Transport.h"
 #include "Async.h"
+#include "CompletionQueue.h"
 #include "Event.h"
 #include "Gateway.h"
 #include "Logger.h"
@@ -45,6 +46,39 @@ namespace FireboltSDK::Transport {
             Config(const Config&) = delete;
             Config& operator=(const Config&) = delete;
 
+            class CategoryLogLevelConfig : public WPEFramework::Core::JSON::Container {
+                public:
+                    CategoryLogLevelConfig()
+                        : WPEFramework::Core::JSON::Container()
+                        , Category()
+                        , Level()
+                    {
+                        Add("category", &Category);
+                        Add("level", &Level);
+                    }
+                    CategoryLogLevelConfig(const CategoryLogLevelConfig& other)
+                        : WPEFramework::Core::JSON::Container()
+                        , Category(other.Category)
+                        , Level(other.Level)
+                    {
+                        Add("category", &Category);
+                        Add("level", &Level);
+                    }
+                    CategoryLogLevelConfig& operator=(const CategoryLogLevelConfig& other)
+                    {
+                        Category = other.Category;
+                        Level = other.Level;
+                        return (*this);
+                    }
+
+                    virtual ~CategoryLogLevelConfig() = default;
+
+                public:
+                    // Such as "Core", overrides logLevel for that category
+                    WPEFramework::Core::JSON::String Category;
+                    WPEFramework::Core::JSON::String Level;
+            };
+
             class WorkerPoolConfig : public WPEFramework::Core::JSON::Container {
                 public:
                     WorkerPoolConfig& operator=(const WorkerPoolConfig&);
@@ -54,10 +88,26 @@ namespace FireboltSDK::Transport {
                         , QueueSize(8)
                         , ThreadCount(3)
                         , StackSize(WPEFramework::Core::Thread::DefaultStackSize())
+                        , Scheduler(_T("shared"))
+                        , MaxThreadCount(0)
+                        , SpawnThreshold(50)
+                        , IdleTimeout(10000)
+                        , Affinity()
+                        , Policy(_T("other"))
+                        , Priority(0)
+                        , ThreadName(_T("firebolt"))
                     {
                         Add("queueSize", &QueueSize);
                         Add("threadCount", &ThreadCount);
                         Add("stackSize", &StackSize);
+                        Add("scheduler", &Scheduler);
+                        Add("maxThreadCount", &MaxThreadCount);
+                        Add("spawnThreshold", &SpawnThreshold);
+                        Add("idleTimeout", &IdleTimeout);
+                        Add("affinity", &Affinity);
+                        Add("policy", &Policy);
+                        Add("priority", &Priority);
+                        Add("threadName", &ThreadName);
                     }
 
                     virtual ~WorkerPoolConfig() = default;
@@ -66,6 +116,19 @@ namespace FireboltSDK::Transport {
                     WPEFramework::Core::JSON::DecUInt32 QueueSize;
                     WPEFramework::Core::JSON::DecUInt32 ThreadCount;
                     WPEFramework::Core::JSON::DecUInt32 StackSize;
+                    // "shared", or "workStealing" which ignores queueSize as its injection queue is unbounded
+                    WPEFramework::Core::JSON::String Scheduler;
+                    // With "workStealing", threads are added up to maxThreadCount while jobs wait for more
+                    // than spawnThreshold ms, and retired down to threadCount after idleTimeout ms without work
+                    WPEFramework::Core::JSON::DecUInt8 MaxThreadCount;
+                    WPEFramework::Core::JSON::DecUInt32 SpawnThreshold;
+                    WPEFramework::Core::JSON::DecUInt32 IdleTimeout;
+                    // CPU list such as "2-3", "other" (priority is the nice level) or "fifo" (real-time
+                    // priority), and the prefix of the thread names
+                    WPEFramework::Core::JSON::String Affinity;
+                    WPEFramework::Core::JSON::String Policy;
+                    WPEFramework::Core::JSON::DecSInt32 Priority;
+                    WPEFramework::Core::JSON::String ThreadName;
                 };
 
 
@@ -73,23 +136,56 @@ namespace FireboltSDK::Transport {
                 : WPEFramework::Core::JSON::Container()
                 , WaitTime(1000)
                 , LogLevel(_T("Info"))
+                , CategoryLogLevels()
+                , LogBurst(50)
+                , LogRate(10)
+                , LogMode(_T("sync"))
+                , LogFile(_T("/tmp/firebolt.fblog"))
+                , LogFileSize(4 * 1024 * 1024)
                 , WorkerPool()
                 , WsUrl(_T("ws://127.0.0.1:9998"))
                 , RPCv2(true)
+                , CancelMethod()
+                , EnableCompletionQueue(false)
+                , ProviderThreads(2)
             {
                 Add(_T("waitTime"), &WaitTime);
                 Add(_T("logLevel"), &LogLevel);
+                Add(_T("categoryLogLevels"), &CategoryLogLevels);
+                Add(_T("logBurst"), &LogBurst);
+                Add(_T("logRate"), &LogRate);
+                Add(_T("logMode"), &LogMode);
+                Add(_T("logFile"), &LogFile);
+                Add(_T("logFileSize"), &LogFileSize);
                 Add(_T("workerPool"), &WorkerPool);
                 Add(_T("wsUrl"), &WsUrl);
                 Add(_T("rpcV2"), &RPCv2);
+                Add(_T("cancelMethod"), &CancelMethod);
+                Add(_T("completionQueue"), &EnableCompletionQueue);
+                Add(_T("providerThreads"), &ProviderThreads);
             }
 
         public:
             WPEFramework::Core::JSON::DecUInt32 WaitTime;
             WPEFramework::Core::JSON::String LogLevel;
+            WPEFramework::Core::JSON::ArrayType<CategoryLogLevelConfig> CategoryLogLevels;
+            // Messages each log statement may write at once, then per second, 0 for no limit
+            WPEFramework::Core::JSON::DecUInt32 LogBurst;
+            WPEFramework::Core::JSON::DecUInt32 LogRate;
+            // "sync", "async" to format and write the logs on a background thread, or "binary"
+            // to store them unformatted in LogFile, for tools/logdecode
+            WPEFramework::Core::JSON::String LogMode;
+            WPEFramework::Core::JSON::String LogFile;
+            WPEFramework::Core::JSON::DecUInt32 LogFileSize;
             WorkerPoolConfig WorkerPool;
             WPEFramework::Core::JSON::String WsUrl;
             WPEFramework::Core::JSON::Boolean RPCv2;
+            // Notified with the id of aborted requests, when the endpoint supports it
+            WPEFramework::Core::JSON::String CancelMethod;
+            // Callbacks are delivered through GetCompletionQueue() rather than on the worker pool
+            WPEFramework::Core::JSON::Boolean EnableCompletionQueue;
+            // Run the provider requests, apart from the worker pool
+            WPEFramework::Core::JSON::DecUInt32 ProviderThreads;
         };
 
         Accessor(const Accessor&) = delete;
@@ -119,7 +215,12 @@ namespace FireboltSDK::Transport {
             RegisterConnectionChangeListener(listener);
             Firebolt::Error status = CreateTransport(_config.WsUrl.Value().c_str(), _config.WaitTime.Value());
             if (status == Firebolt::Error::None) {
+                _transport->SetInlineReceive(_completionQueue != nullptr);
                 Async::Instance().Configure(_transport);
+                Async::Instance().SetCompletionQueue(_completionQueue);
+                Gateway::Instance().SetCompletionQueue(_completionQueue);
+                Gateway::Instance().SetCancelMethod(_config.CancelMethod.Value());
+                Gateway::Instance().SetProviderThreads(_config.ProviderThreads.Value());
                 Gateway::Instance().TransportUpdated(_transport);
                 status = CreateEventHandler();
             }
@@ -144,6 +245,7 @@ namespace FireboltSDK::Transport {
 
             Async::Dispose();
             Gateway::Instance().TransportUpdated(nullptr);
+            Gateway::Instance().SetCompletionQueue(nullptr);
             DestroyTransport();
 
             return Firebolt::Error::None;
@@ -156,6 +258,19 @@ namespace FireboltSDK::Transport {
 
         Event& GetEventManager();
 
+        // Queueing and run times of the worker pool jobs, by kind of job
+        WorkerPoolStatistics GetWorkerPoolStatistics() const
+        {
+            return _workerPool->Statistics();
+        }
+
+        // Set when enabled by the "completionQueue" configuration, the host then polls its
+        // Descriptor() and calls Drain() from its own loop
+        CompletionQueue* GetCompletionQueue() const
+        {
+            return _completionQueue;
+        }
+
     private:
         Firebolt::Error CreateEventHandler();
         Firebolt::Error DestroyEventHandler();
@@ -169,6 +284,7 @@ namespace FireboltSDK::Transport {
 
         WPEFramework::Core::ProxyType<WorkerPoolImplementation> _workerPool;
         Transport<WPEFramework::Core::JSON::IElement>* _transport;
+        CompletionQueue* _completionQueue;
         static Accessor* _singleton;
         Config _config;
 
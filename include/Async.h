@@ -21,6 +21,11 @@
 #include "Portability.h"
 #include "Module.h"
 #include "Gateway.h"
+#include "CompletionQueue.h"
+#include "WorkerPoolStatistics.h"
+
+#include <array>
+#include <atomic>
 
 namespace FireboltSDK::Transport {
 
@@ -33,14 +38,14 @@ namespace FireboltSDK::Transport {
         Async& operator= (const Async&) = delete;
 
     public:
-        typedef std::function<Firebolt::Error(Async& parent, void*)> DispatchFunction;
+        typedef std::function<void(Async& parent, void*)> DispatchFunction;
 
-        class Job : public WPEFramework::Core::IDispatch {
+        class Job : public TrackedJob {
         protected:
-            Job(Async& parent, const string& method, const DispatchFunction lambda, void* usercb)
-                : _parent(parent)
-                , _method(method)
-                , _lambda(lambda)
+            Job(Async& parent, DispatchFunction&& lambda, void* usercb)
+                : TrackedJob(JobKind::Async)
+                , _parent(parent)
+                , _lambda(std::move(lambda))
                 , _usercb(usercb)
             {
             }
@@ -53,128 +58,232 @@ namespace FireboltSDK::Transport {
             ~Job() = default;
 
         public:
-            static WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> Create(Async& parent, const string& method, const DispatchFunction lambda, void* usercb);
-
-            void Dispatch() override
+            void Run() override
             {
                 _lambda(_parent, _usercb);
             }
 
         private:
             Async& _parent;
-            string _method;
             DispatchFunction _lambda;
             void* _usercb;
         };
 
    public:
+        // Identifies one Invoke() call, never reused
+        using Handle = uint64_t;
+        static constexpr Handle InvalidHandle = 0;
+
         struct CallbackData {
-            const DispatchFunction lambda;
-            WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> job;
+            AtomId method = InvalidAtom;
+            void* usercb = nullptr;
+            // Outstanding request, 0 once answered or when not known yet
+            MessageID id = 0;
+            // Delivers the response, only created once it has arrived
+            WPEFramework::Core::ProxyType<Job> job;
         };
 
-        using CallbackMap = std::map<void*, CallbackData>;
-        using MethodMap = std::map<string, CallbackMap>;
+        using CallMap = std::unordered_map<Handle, CallbackData>;
 
     private:
         static constexpr uint32_t DefaultWaitTime = WPEFramework::Core::infinite;
+        static constexpr uint8_t ShardCount = 16;
+
+        // Calls are spread by handle, so that concurrent completions rarely share a lock
+        struct Shard {
+            WPEFramework::Core::CriticalSection lock;
+            CallMap calls;
+        };
 
     public:
         static Async& Instance();
         static void Dispose();
         void Configure(Transport<WPEFramework::Core::JSON::IElement>* transport);
 
+        // Callbacks are then run by whoever drains 'queue' instead of the worker pool
+        void SetCompletionQueue(CompletionQueue* queue)
+        {
+            _completionQueue = queue;
+        }
+
     public:
         template <typename RESPONSE, typename PARAMETERS, typename CALLBACK>
         Firebolt::Error Invoke(const string& method, const PARAMETERS& parameters, const CALLBACK& callback, void* usercb, uint32_t waitTime = DefaultWaitTime)
         {
-            Firebolt::Error status = Firebolt::Error::None;
+            Handle handle;
+            return Invoke<RESPONSE>(method, parameters, callback, usercb, handle, waitTime);
+        }
+
+        // Outstanding requests hold no thread, the callback is run on the worker pool once
+        // the response has arrived, or with a null response and the error when the call
+        // fails or times out. 'handle' identifies the call to Abort() it, aborted calls get
+        // no callback. A 'waitTime' other than infinite bounds the wait for the response, in ms.
+        // The response is handed over as a ProxyType<RESPONSE>* only valid during the callback,
+        // a callback keeping the response takes a copy of the proxy rather than deleting it.
+        template <typename RESPONSE, typename PARAMETERS, typename CALLBACK>
+        Firebolt::Error Invoke(const string& method, const PARAMETERS& parameters, const CALLBACK& callback, void* usercb, Handle& handle, uint32_t waitTime = DefaultWaitTime)
+        {
             std::function<void(void* usercb, void* response, Firebolt::Error status)> actualCallback = callback;
-            DispatchFunction lambda = [actualCallback, method, parameters, waitTime](Async& parent, void* usercb) -> Firebolt::Error {
-                RESPONSE response;
-                Firebolt::Error status = Gateway::Instance().Request(method, parameters, response);
-                if (status == Firebolt::Error::None && parent.IsActive(method, usercb) == true) {
-                    WPEFramework::Core::ProxyType<RESPONSE>* jsonResponse = new WPEFramework::Core::ProxyType<RESPONSE>();
-                    *jsonResponse = WPEFramework::Core::ProxyType<RESPONSE>::Create();
-                    (*jsonResponse)->FromString(response);
-                    actualCallback(usercb, jsonResponse, status);
-                    parent.RemoveEntry(method, usercb);
 
-                }
-                return (status);
-            };
-
-
-            _adminLock.Lock();
-            WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> job = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Async::Job>::Create(*this, method, lambda, usercb));
-            CallbackData callbackData = {lambda, job};
-            MethodMap::iterator index = _methodMap.find(method);
-            if (index != _methodMap.end()) {
-                CallbackMap::iterator callbackIndex = index->second.find(usercb);
-                if (callbackIndex == index->second.end()) {
-                    index->second.emplace(std::piecewise_construct, std::forward_as_tuple(usercb), std::forward_as_tuple(callbackData));
-                }
+            handle = _nextHandle.fetch_add(1, std::memory_order_relaxed);
+            Shard& shard = ShardOf(handle);
+            shard.lock.Lock();
+            CallbackData& callbackData = shard.calls[handle];
+            callbackData.method = Atoms::Instance().Intern(method);
+            callbackData.usercb = usercb;
+            shard.lock.Unlock();
+
+            MessageID id = 0;
+            Firebolt::Error status = Gateway::Instance().RequestAsync(method, parameters,
+                [actualCallback, handle, usercb](Firebolt::Error status, const string& result) {
+                    // Runs on the transport thread, only hands the response over
+                    Async* parent = _singleton;
+                    if (parent == nullptr || parent->IsActive(handle) == false) {
+                        return;
+                    }
+                    if (status != Firebolt::Error::None) {
+                        parent->Deliver(handle, usercb, [actualCallback, handle, status](Async& parent, void* usercb) {
+                            if (parent.IsActive(handle) == true) {
+                                actualCallback(usercb, nullptr, status);
+                                parent.RemoveEntry(handle);
+                            }
+                        });
+                        return;
+                    }
+                    parent->Deliver(handle, usercb, [actualCallback, handle, response = result](Async& parent, void* usercb) {
+                        if (parent.IsActive(handle) == true) {
+                            WPEFramework::Core::ProxyType<RESPONSE> jsonResponse = WPEFramework::Core::ProxyType<RESPONSE>::Create();
+                            jsonResponse->FromString(response);
+                            actualCallback(usercb, &jsonResponse, Firebolt::Error::None);
+                            parent.RemoveEntry(handle);
+                        }
+                    });
+                }, id, (waitTime != WPEFramework::Core::infinite) ? waitTime : 0);
+            if (status != Firebolt::Error::None) {
+                RemoveEntry(handle);
             } else {
-                CallbackMap callbackMap;
-                callbackMap.emplace(std::piecewise_construct, std::forward_as_tuple(usercb), std::forward_as_tuple(callbackData));
-                _methodMap.emplace(std::piecewise_construct, std::forward_as_tuple(method), std::forward_as_tuple(callbackMap));
+                // Unless it was answered already, so that Abort() can cancel it
+                shard.lock.Lock();
+                CallMap::iterator index = shard.calls.find(handle);
+                if (index != shard.calls.end() && index->second.job.IsValid() == false) {
+                    index->second.id = id;
+                }
+                shard.lock.Unlock();
             }
-            _adminLock.Unlock();
-
-            WPEFramework::Core::IWorkerPool::Instance().Submit(job);
 
             return status;
         }
 
-        Firebolt::Error Abort(const string& method, void* usercb)
+        // The request still in flight is cancelled, its response is not waited for
+        Firebolt::Error Abort(const Handle handle)
         {
-            RemoveEntry(method, usercb);
+            MessageID id = RemoveEntry(handle);
+            if (id != 0) {
+                Gateway::Instance().Cancel(id);
+            }
             return (Firebolt::Error::None);
         }
 
-        void RemoveEntry(const string& method, void* usercb)
+        // Aborts all the calls of 'method' made for 'usercb'
+        Firebolt::Error Abort(const string& method, void* usercb)
         {
-            _adminLock.Lock();
-            MethodMap::iterator index = _methodMap.find(method);
-            if (index != _methodMap.end()) {
-                CallbackMap::iterator callbackIndex = index->second.find(usercb);
-                if (callbackIndex != index->second.end()) {
-                    if (IsValidJob(callbackIndex->second)) {
-                        WPEFramework::Core::IWorkerPool::Instance().Revoke(callbackIndex->second.job);
-                    }
-                    index->second.erase(callbackIndex);
-                    if (index->second.size() == 0) {
-                        _methodMap.erase(index);
+            AtomId methodId = Atoms::Instance().Find(method);
+            if (methodId == InvalidAtom) {
+                return (Firebolt::Error::None);
+            }
+
+            std::vector<Handle> handles;
+            for (Shard& shard : _shards) {
+                shard.lock.Lock();
+                for (const auto& call : shard.calls) {
+                    if (call.second.method == methodId && call.second.usercb == usercb) {
+                        handles.push_back(call.first);
                     }
                 }
+                shard.lock.Unlock();
             }
-            _adminLock.Unlock();
+            for (Handle handle : handles) {
+                Abort(handle);
+            }
+            return (Firebolt::Error::None);
         }
 
-        bool IsActive(const string& method, void* usercb)
+        // Returns the id of the request still outstanding for the call, if any
+        MessageID RemoveEntry(const Handle handle)
         {
-            bool valid = false;
-            _adminLock.Lock();
-            MethodMap::iterator index = _methodMap.find(method);
-            if (index != _methodMap.end()) {
-                CallbackMap::iterator callbackIndex = index->second.find(usercb);
-                if (callbackIndex != index->second.end()) {
-                    valid = true;
+            MessageID id = 0;
+            WPEFramework::Core::ProxyType<Job> job;
+            Shard& shard = ShardOf(handle);
+            shard.lock.Lock();
+            CallMap::iterator index = shard.calls.find(handle);
+            if (index != shard.calls.end()) {
+                if (IsValidJob(index->second)) {
+                    job = index->second.job;
+                } else {
+                    id = index->second.id;
                 }
+                shard.calls.erase(index);
             }
-            _adminLock.Unlock();
+            shard.lock.Unlock();
+
+            // Revoking waits for the job if it is running, which may be removing an entry of this shard
+            if (job.IsValid()) {
+                TrackedJob::Revoke(job);
+            }
+            return id;
+        }
+
+        bool IsActive(const Handle handle)
+        {
+            Shard& shard = ShardOf(handle);
+            shard.lock.Lock();
+            bool valid = (shard.calls.find(handle) != shard.calls.end());
+            shard.lock.Unlock();
             return valid;
         }
 
     private:
+        Shard& ShardOf(const Handle handle)
+        {
+            return _shards[handle % ShardCount];
+        }
+
+        void Deliver(const Handle handle, void* usercb, DispatchFunction&& lambda)
+        {
+            CompletionQueue* completionQueue = _completionQueue;
+            if (completionQueue != nullptr) {
+                completionQueue->Post([lambda = std::move(lambda), usercb]() {
+                    if (_singleton != nullptr) {
+                        lambda(*_singleton, usercb);
+                    }
+                });
+                return;
+            }
+
+            WPEFramework::Core::ProxyType<Job> job;
+            Shard& shard = ShardOf(handle);
+            shard.lock.Lock();
+            CallMap::iterator index = shard.calls.find(handle);
+            if (index != shard.calls.end()) {
+                job = WPEFramework::Core::ProxyType<Async::Job>::Create(*this, std::move(lambda), usercb);
+                index->second.job = job;
+            }
+            shard.lock.Unlock();
+
+            if (job.IsValid()) {
+                TrackedJob::Submit(job);
+            }
+        }
+
         void Clear();
         inline bool IsValidJob(CallbackData& callbackData) {
             return (callbackData.job.IsValid());
         }
 
     private:
-        MethodMap _methodMap;
-        WPEFramework::Core::CriticalSection _adminLock;
+        std::array<Shard, ShardCount> _shards;
+        std::atomic<Handle> _nextHandle;
+        std::atomic<CompletionQueue*> _completionQueue;
 
         static Async* _singleton;
     };
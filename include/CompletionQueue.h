@@ -0,0 +1,73 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Portability.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace FireboltSDK::Transport
+{
+    // Completions handed over to a thread of the host's choosing, typically its main loop.
+    // Descriptor() becomes readable whenever tasks are queued, Drain() then runs them on
+    // the calling thread. Posting is lock-free and can be done from any thread, draining
+    // must be done from one thread at a time.
+    class FIREBOLTSDK_EXPORT CompletionQueue {
+    public:
+        using Task = std::function<void()>;
+
+    private:
+        struct Node {
+            std::atomic<Node*> next { nullptr };
+            Task task;
+        };
+
+    public:
+        CompletionQueue();
+        CompletionQueue(const CompletionQueue&) = delete;
+        CompletionQueue& operator=(const CompletionQueue&) = delete;
+        ~CompletionQueue();
+
+    public:
+        // eventfd to poll for readability, -1 if it could not be created
+        int Descriptor() const
+        {
+            return _descriptor;
+        }
+
+        void Post(Task&& task);
+
+        // Runs the tasks queued so far, returns how many were run
+        uint32_t Drain();
+
+    private:
+        void Push(Node* node);
+        Node* Pop();
+
+    private:
+        // Producers append at the head, the consumer takes from the tail (Vyukov's MPSC queue)
+        std::atomic<Node*> _head;
+        Node* _tail;
+        Node _stub;
+        int _descriptor;
+    };
+}
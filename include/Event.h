@@ -54,14 +54,48 @@ namespace FireboltSDK::Transport
         }
 
         template <typename RESULT, typename CALLBACK>
-        Firebolt::Error Subscribe(const string& eventName, JsonObject& jsonParameters, const CALLBACK& callback, void* usercb, const void* userdata, bool prioritize = false)
+        Firebolt::Error Subscribe(const string& eventName, JsonObject& jsonParameters, const CALLBACK& callback, void* usercb, const void* userdata, bool prioritize = false, const SubscriptionOptions& options = {})
         {
-            return Gateway::Instance().Subscribe<RESULT>(eventName, jsonParameters, callback, usercb, userdata, prioritize);
+            return Gateway::Instance().Subscribe<RESULT>(eventName, jsonParameters, callback, usercb, userdata, prioritize, options);
         }
 
         Firebolt::Error Unsubscribe(const string& eventName, void* usercb)
         {
-            return Gateway::Instance().Unsubscribe(eventName);
+            return Gateway::Instance().Unsubscribe(eventName, usercb);
+        }
+
+        // Subscribe() and Unsubscribe() in two steps, see GatewayImpl
+        template <typename RESULT, typename CALLBACK>
+        PendingSubscription BeginSubscribe(const string& eventName, JsonObject& jsonParameters, const CALLBACK& callback, void* usercb, const void* userdata, const SubscriptionOptions& options = {})
+        {
+            return Gateway::Instance().BeginSubscribe<RESULT>(eventName, jsonParameters, callback, usercb, userdata, options);
+        }
+
+        // 'key' as given by a Descriptor
+        template <typename RESULT, typename CALLBACK>
+        PendingSubscription BeginSubscribe(AtomId key, const string& eventName, JsonObject& jsonParameters, const CALLBACK& callback, void* usercb, const void* userdata, const SubscriptionOptions& options = {})
+        {
+            return Gateway::Instance().BeginSubscribe<RESULT>(key, eventName, jsonParameters, callback, usercb, userdata, options);
+        }
+
+        Firebolt::Error EndSubscribe(PendingSubscription& pending)
+        {
+            return Gateway::Instance().EndSubscribe(pending);
+        }
+
+        PendingUnsubscription BeginUnsubscribe(const string& eventName, void* usercb)
+        {
+            return Gateway::Instance().BeginUnsubscribe(eventName, usercb);
+        }
+
+        PendingUnsubscription BeginUnsubscribe(AtomId key, const string& eventName, void* usercb)
+        {
+            return Gateway::Instance().BeginUnsubscribe(key, eventName, usercb);
+        }
+
+        Firebolt::Error EndUnsubscribe(PendingUnsubscription& pending)
+        {
+            return Gateway::Instance().EndUnsubscribe(pending);
         }
 
         template <typename RESULT, typename CALLBACK>
@@ -21,6 +21,7 @@
 
 #include "Accessor.h"
 #include "Async.h"
+#include "CompletionQueue.h"
 #include "Logger.h"
 #include "Properties.h"
 #include "Transport.h"
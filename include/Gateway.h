@@ -60,15 +60,75 @@ public:
         return implementation->Request(method, parameters, response);
     }
 
+    // The response is handed to 'completion' when it arrives, no thread waits for it
+    Firebolt::Error RequestAsync(const std::string &method, const JsonObject &parameters, Client::Completion &&completion, MessageID &id, uint64_t timeout_ms = 0)
+    {
+        return implementation->RequestAsync(method, parameters, std::move(completion), id, timeout_ms);
+    }
+
+    // Releases an outstanding request issued with RequestAsync()
+    void Cancel(MessageID id)
+    {
+        implementation->Cancel(id);
+    }
+
+    void SetCancelMethod(const std::string &method)
+    {
+        implementation->SetCancelMethod(method);
+    }
+
+    void SetCompletionQueue(CompletionQueue* queue)
+    {
+        implementation->SetCompletionQueue(queue);
+    }
+
+    void SetProviderThreads(uint32_t count)
+    {
+        implementation->SetProviderThreads(count);
+    }
+
     template <typename RESULT, typename CALLBACK>
-    Firebolt::Error Subscribe(const string& event, JsonObject& parameters, const CALLBACK& callback, void* usercb, const void* userdata, bool prioritize = false)
+    Firebolt::Error Subscribe(const string& event, JsonObject& parameters, const CALLBACK& callback, void* usercb, const void* userdata, bool prioritize = false, const SubscriptionOptions& options = {})
+    {
+        return implementation->Subscribe<RESULT>(event, parameters, callback, usercb, userdata, prioritize, options);
+    }
+
+    Firebolt::Error Unsubscribe(const std::string& event, void* usercb = nullptr)
+    {
+        return implementation->Unsubscribe(event, usercb);
+    }
+
+    // Split in two, so that the requests of several subscriptions can be pipelined
+    template <typename RESULT, typename CALLBACK>
+    PendingSubscription BeginSubscribe(const string& event, JsonObject& parameters, const CALLBACK& callback, void* usercb, const void* userdata, const SubscriptionOptions& options = {})
+    {
+        return implementation->BeginSubscribe<RESULT>(event, parameters, callback, usercb, userdata, options);
+    }
+
+    template <typename RESULT, typename CALLBACK>
+    PendingSubscription BeginSubscribe(AtomId key, const string& event, JsonObject& parameters, const CALLBACK& callback, void* usercb, const void* userdata, const SubscriptionOptions& options = {})
+    {
+        return implementation->BeginSubscribe<RESULT>(key, event, parameters, callback, usercb, userdata, options);
+    }
+
+    Firebolt::Error EndSubscribe(PendingSubscription& pending)
+    {
+        return implementation->EndSubscribe(pending);
+    }
+
+    PendingUnsubscription BeginUnsubscribe(const std::string& event, void* usercb = nullptr)
+    {
+        return implementation->BeginUnsubscribe(event, usercb);
+    }
+
+    PendingUnsubscription BeginUnsubscribe(AtomId key, const std::string& event, void* usercb = nullptr)
     {
-        return implementation->Subscribe<RESULT>(event, parameters, callback, usercb, userdata, prioritize);
+        return implementation->BeginUnsubscribe(key, event, usercb);
     }
 
-    Firebolt::Error Unsubscribe(const std::string& event)
+    Firebolt::Error EndUnsubscribe(PendingUnsubscription& pending)
     {
-        return implementation->Unsubscribe(event);
+        return implementation->EndUnsubscribe(pending);
     }
 
     template <typename RESPONSE, typename PARAMETERS, typename CALLBACK>
@@ -21,8 +21,14 @@
 #include "Portability.h"
 #include "Module.h"
 #include "error.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstring>
 #include <stdint.h>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace FireboltSDK::Transport {
 
@@ -39,6 +45,15 @@ namespace FireboltSDK::Transport {
             MaxLevel
         };
 
+        enum class Mode : uint8_t {
+            // Formatted and written by the calling thread
+            Sync,
+            // Queued to a per-thread ring buffer, formatted and written by a background thread
+            Async,
+            // Raw arguments stored in a memory-mapped file, see SetBinaryLog()
+            Binary
+        };
+
         enum class Category : uint8_t {
             OpenRPC,
             Core,
@@ -46,6 +61,105 @@ namespace FireboltSDK::Transport {
             Discovery,
             PlayerProvider,
             PlayerManager,
+            MaxCategory
+        };
+
+        // One per log statement, described once in the sites file of the binary log
+        struct Site {
+            Site(const LogLevel logLevel, const Category logCategory, const char* fileName, const char* functionName, const uint16_t lineNumber)
+                : level(logLevel)
+                , category(logCategory)
+                , file(fileName)
+                , function(functionName)
+                , line(lineNumber)
+            {
+            }
+
+            const LogLevel level;
+            const Category category;
+            const char* const file;
+            const char* const function;
+            const uint16_t line;
+            // Assigned on first use, 0 until then
+            std::atomic<uint32_t> id { 0 };
+            // Rate limiting, the time (us) the bucket is full again and the messages dropped since the last one written
+            std::atomic<uint64_t> due { 0 };
+            std::atomic<uint32_t> suppressed { 0 };
+        };
+
+        // Arguments of one binary record, stored as they are and formatted by the decoder
+        class Payload {
+        public:
+            Payload(const Payload&) = delete;
+            Payload& operator=(const Payload&) = delete;
+            Payload() = default;
+
+            // What Add() can store, anything else is logged as text
+            template <typename TYPE>
+            static constexpr bool Supported()
+            {
+                return std::is_enum_v<TYPE> || std::is_integral_v<TYPE> || std::is_floating_point_v<TYPE> || std::is_array_v<TYPE>
+                    || std::is_convertible_v<const TYPE&, std::string_view> || std::is_pointer_v<TYPE>;
+            }
+
+            template <typename TYPE>
+            void Add(const TYPE& value)
+            {
+                if constexpr (std::is_enum_v<TYPE>) {
+                    Add(static_cast<std::underlying_type_t<TYPE>>(value));
+                } else if constexpr (std::is_integral_v<TYPE> && std::is_signed_v<TYPE>) {
+                    Put('i', static_cast<int64_t>(value));
+                } else if constexpr (std::is_integral_v<TYPE>) {
+                    Put('u', static_cast<uint64_t>(value));
+                } else if constexpr (std::is_floating_point_v<TYPE>) {
+                    Put('d', static_cast<double>(value));
+                } else if constexpr (std::is_array_v<TYPE> || std::is_same_v<std::decay_t<TYPE>, char*> || std::is_same_v<std::decay_t<TYPE>, const char*>) {
+                    const char* text = value;
+                    PutString((text != nullptr) ? std::string_view(text) : std::string_view("(null)"));
+                } else if constexpr (std::is_convertible_v<const TYPE&, std::string_view>) {
+                    PutString(std::string_view(value));
+                } else if constexpr (std::is_pointer_v<TYPE>) {
+                    Put('p', static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+                } else {
+                    static_assert(sizeof(TYPE) == 0, "Unsupported log argument type");
+                }
+            }
+
+            const uint8_t* Data() const
+            {
+                return _data;
+            }
+            uint16_t Size() const
+            {
+                return _size;
+            }
+
+        private:
+            template <typename TYPE>
+            void Put(const char tag, const TYPE value)
+            {
+                if ((_size + 1 + sizeof(value)) <= sizeof(_data)) {
+                    _data[_size++] = tag;
+                    memcpy(&_data[_size], &value, sizeof(value));
+                    _size += sizeof(value);
+                }
+            }
+            void PutString(std::string_view text)
+            {
+                if ((_size + 1 + sizeof(uint16_t)) <= sizeof(_data)) {
+                    // Truncated rather than dropped when it does not fit
+                    uint16_t length = static_cast<uint16_t>(std::min(text.size(), sizeof(_data) - _size - 1 - sizeof(uint16_t)));
+                    _data[_size++] = 's';
+                    memcpy(&_data[_size], &length, sizeof(length));
+                    _size += sizeof(length);
+                    memcpy(&_data[_size], text.data(), length);
+                    _size += length;
+                }
+            }
+
+        private:
+            uint8_t _data[MaxBufSize];
+            uint16_t _size = 0;
         };
 
     public:
@@ -55,29 +169,121 @@ namespace FireboltSDK::Transport {
         ~Logger() = default;
 
     public:
+        // Of all the categories
         static Firebolt::Error SetLogLevel(LogLevel logLevel);
-        static void Log(LogLevel logLevel, Category category, const std::string& module, const std::string file, const std::string function, const uint16_t line, const std::string& format, ...);
+        static Firebolt::Error SetLogLevel(Category category, LogLevel logLevel);
+        static bool IsEnabled(const LogLevel logLevel, const Category category)
+        {
+            return (logLevel <= _logLevels[static_cast<uint8_t>(category)].load(std::memory_order_relaxed));
+        }
+        // Each log statement may write 'burst' messages at once, then 'rate' a second. The
+        // messages dropped are counted in the next one written. 0 lifts the limit, Binary
+        // mode has none.
+        static void SetRateLimit(const uint32_t burst, const uint32_t rate);
+        // Switching back to Sync writes out whatever is still queued, Binary falls back to
+        // Sync until SetBinaryLog() succeeded
+        static void SetMode(Mode mode);
+        // Messages lost in Async mode, their thread's ring buffer being full
+        static uint64_t Dropped();
+        // Opens the file ring used in Binary mode, 'size' bytes of records. The log statements
+        // are described in '<path>.sites', read along with it by tools/logdecode.
+        static Firebolt::Error SetBinaryLog(const std::string& path, const uint32_t size);
+        static bool IsBinary()
+        {
+            return (_mode.load(std::memory_order_relaxed) == Mode::Binary);
+        }
+        // Use the macros below, they only evaluate the arguments when the level is enabled.
+        // Not tied to a static log statement, so written by the calling thread whatever the mode.
+        static void Log(LogLevel logLevel, Category category, const std::string& module, const char* file, const char* function, const uint16_t line, const char* format, ...);
+        // Rate limited
+        static void Log(Site& site, const std::string& module, const char* format, ...);
 
     public:
+        // Worked out once per type
         template<typename CLASS>
-        static const string Module()
+        static const string& Module()
         {
-            return WPEFramework::Core::ClassNameOnly(typeid(CLASS).name()).Text(); 
+            static const string name = WPEFramework::Core::ClassNameOnly(typeid(CLASS).name()).Text();
+            return name;
         }
 
+        // Nothing is formatted, the arguments are copied in the file ring as they are. A
+        // statement with an argument the ring cannot hold is formatted as text instead.
+        template <typename... ARGUMENTS>
+        static void LogBinary(Site& site, const std::string& module, const char* format, const ARGUMENTS&... arguments)
+        {
+            if constexpr ((Payload::Supported<ARGUMENTS>() && ...)) {
+                uint32_t id = site.id.load(std::memory_order_acquire);
+                if (id == 0) {
+                    id = Register(site, module, format);
+                }
+                Payload payload;
+                (payload.Add(arguments), ...);
+                Append(id, payload);
+            } else {
+                Log(site, module, format, arguments...);
+            }
+        }
+
+    private:
+        static bool Admit(Site& site);
+        static void Print(const Site& site, const std::string& module, const char* format, ...);
+        static void Emit(const Site& site, const std::string& module, const char* format, va_list arguments);
+        static uint32_t Register(Site& site, const std::string& module, const char* format);
+        static void Append(const uint32_t site, const Payload& payload);
+
     private:
-        static LogLevel _logLevel;
+        struct Record;
+        class Ring;
+        class Backend;
+
+        static void Write(const Record& record);
+
+    private:
+        static std::atomic<LogLevel> _logLevels[static_cast<uint8_t>(Category::MaxCategory)];
+        static std::atomic<Mode> _mode;
+        static std::atomic<uint32_t> _burst;
+        // Between two messages once the burst is spent, in us, 0 when not limited
+        static std::atomic<uint64_t> _interval;
     };
 }
+// Most verbose level compiled in, from 0 (Error) to 3 (Debug), set by FIREBOLT_LOG_COMPILED_LEVEL in CMake
+#ifndef FIREBOLT_LOG_COMPILED_LEVEL
+#define FIREBOLT_LOG_COMPILED_LEVEL 3
+#endif
+
 #define FIREBOLT_LOG(level, category, module, ...) \
-    do { FireboltSDK::Transport::Logger::Log(level, category, module, __FILE__, __func__, __LINE__, __VA_ARGS__); } while (0)
+    do { \
+        if (FireboltSDK::Transport::Logger::IsEnabled(level, category)) { \
+            static FireboltSDK::Transport::Logger::Site fireboltLogSite(level, category, __FILE__, __func__, __LINE__); \
+            if (FireboltSDK::Transport::Logger::IsBinary()) { \
+                FireboltSDK::Transport::Logger::LogBinary(fireboltLogSite, module, __VA_ARGS__); \
+            } else { \
+                FireboltSDK::Transport::Logger::Log(fireboltLogSite, module, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+#define FIREBOLT_LOG_NONE(...) \
+    do { } while (0)
 
 #define FIREBOLT_LOG_ERROR(category, module, ...) \
     do { FIREBOLT_LOG(FireboltSDK::Transport::Logger::LogLevel::Error, category, module, __VA_ARGS__); } while (0)
+#if FIREBOLT_LOG_COMPILED_LEVEL >= 1
 #define FIREBOLT_LOG_WARNING(category, module, ...) \
     do { FIREBOLT_LOG(FireboltSDK::Transport::Logger::LogLevel::Warning, category, module, __VA_ARGS__); } while (0)
+#else
+#define FIREBOLT_LOG_WARNING(...) FIREBOLT_LOG_NONE()
+#endif
+#if FIREBOLT_LOG_COMPILED_LEVEL >= 2
 #define FIREBOLT_LOG_INFO(category, module, ...) \
     do { FIREBOLT_LOG(FireboltSDK::Transport::Logger::LogLevel::Info, category, module, __VA_ARGS__); } while (0)
+#else
+#define FIREBOLT_LOG_INFO(...) FIREBOLT_LOG_NONE()
+#endif
+#if FIREBOLT_LOG_COMPILED_LEVEL >= 3
 #define FIREBOLT_LOG_DEBUG(category, module, ...) \
     do { FIREBOLT_LOG(FireboltSDK::Transport::Logger::LogLevel::Debug, category, module, __VA_ARGS__); } while (0)
-
+#else
+#define FIREBOLT_LOG_DEBUG(...) FIREBOLT_LOG_NONE()
+#endif
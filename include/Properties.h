@@ -54,9 +54,9 @@ namespace FireboltSDK::Transport {
         }
 
         template <typename RESULT, typename CALLBACK>
-        static Firebolt::Error Subscribe(const string& propertyName, JsonObject& paramsters, const CALLBACK& callback, void* usercb, const void* userdata)
+        static Firebolt::Error Subscribe(const string& propertyName, JsonObject& paramsters, const CALLBACK& callback, void* usercb, const void* userdata, const SubscriptionOptions& options = {})
         {
-            return Event::Instance().Subscribe<RESULT, CALLBACK>(EventName(propertyName), paramsters, callback, usercb, userdata);
+            return Event::Instance().Subscribe<RESULT, CALLBACK>(EventName(propertyName), paramsters, callback, usercb, userdata, false, options);
         }
 
         static Firebolt::Error Unsubscribe(const string& propertyName, void* usercb)
@@ -66,11 +66,17 @@ namespace FireboltSDK::Transport {
     private:
         static inline string EventName(const string& propertyName) {
             size_t pos = propertyName.find_first_of('.');
-            string eventName = propertyName;
-            if (pos != std::string::npos) {
-               eventName[pos + 1] = std::toupper(eventName[pos + 1]);
-               eventName = string(eventName.substr(0, pos + 1) + "on" + eventName.substr(pos + 1) + "Changed");
+            if (pos == std::string::npos || pos + 1 == propertyName.size()) {
+                return propertyName;
             }
+            // "module.property" -> "module.onPropertyChanged", built in place with a single allocation
+            string eventName;
+            eventName.reserve(propertyName.size() + 9);
+            eventName.append(propertyName, 0, pos + 1);
+            eventName.append("on");
+            eventName.push_back(std::toupper(propertyName[pos + 1]));
+            eventName.append(propertyName, pos + 2, string::npos);
+            eventName.append("Changed");
             return eventName;
         }
     };
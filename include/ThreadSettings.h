@@ -0,0 +1,46 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace FireboltSDK::Transport {
+
+    // Placement and scheduling of the worker pool threads, each applies them as it starts
+    struct ThreadSettings {
+        enum class Policy : uint8_t {
+            // SCHED_OTHER, Priority is the nice level
+            Other,
+            // SCHED_FIFO, Priority is the real-time priority; needs the privilege to do so
+            Fifo
+        };
+
+        // CPUs the threads are bound to, as a "0-1,3" list; not bound when empty
+        std::string Affinity;
+        Policy Scheduling = Policy::Other;
+        int32_t Priority = 0;
+        // Threads are named "<Name>-<n>", left alone when empty
+        std::string Name;
+
+        // Applies them to the calling thread, failures are logged and otherwise ignored
+        void Apply(const uint8_t index) const;
+    };
+}
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include "Module.h"
 #include "error.h"
@@ -25,6 +26,9 @@
 #include "json_engine.h"
 #endif
 #include "CommunicationChannel.h"
+#include "gateway/atoms.h"
+#include "gateway/frame.h"
+#include "WorkerPoolStatistics.h"
 
 namespace FireboltSDK::Transport
 {
@@ -33,7 +37,23 @@ namespace FireboltSDK::Transport
 
     class ITransportReceiver {
     public:
-        virtual void Receive(const WPEFramework::Core::JSONRPC::Message& message) = 0;
+        // Asked on the socket thread before the message is queued, what is not wanted is
+        // dropped there. Only the kind, id and method of 'frame' are to be looked at.
+        virtual bool Wanted(const Frame& frame)
+        {
+            return ((frame.Type() != Frame::Kind::Invalid) && ((frame.Type() != Frame::Kind::Event) || (frame.Key() != InvalidAtom)));
+        }
+        virtual void Receive(const Frame& frame) = 0;
+        // A notification is 'superseded' when a newer one of the same event is queued behind it
+        virtual void Receive(const Frame& frame, const bool superseded)
+        {
+            Receive(frame);
+        }
+        // The strand of an event with subscribers is kept once drained, others are dropped
+        virtual bool Subscribed(const AtomId event)
+        {
+            return false;
+        }
     };
 
     class IEventHandler
@@ -51,14 +71,14 @@ namespace FireboltSDK::Transport
         using Channel = CommunicationChannel<WPEFramework::Core::SocketStream, INTERFACE, Transport, WPEFramework::Core::JSONRPC::Message>;
         using Entry = typename CommunicationChannel<WPEFramework::Core::SocketStream, INTERFACE, Transport, WPEFramework::Core::JSONRPC::Message>::Entry;
         using PendingMap = std::unordered_map<uint32_t, Entry>;
-        using EventMap = std::map<string, uint32_t>;
+        using EventMap = std::unordered_map<AtomId, uint32_t>;
         typedef std::function<uint32_t(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &jsonResponse, bool &enabled)> EventResponseValidatioionFunction;
 
-        class CommunicationJob : public WPEFramework::Core::IDispatch
+        class CommunicationJob : public TrackedJob
         {
         protected:
-            CommunicationJob(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &inbound, class Transport *parent)
-                : _inbound(inbound), _parent(parent)
+            CommunicationJob(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &inbound, const AtomId key, class Transport *parent)
+                : TrackedJob(JobKind::Communication), _inbound(inbound), _key(key), _parent(parent)
             {
             }
 
@@ -70,23 +90,87 @@ namespace FireboltSDK::Transport
             ~CommunicationJob() = default;
 
         public:
-            static WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> Create(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &inbound, class Transport *parent);
-
-            void Dispatch() override
+            void Run() override
             {
-                _parent->Inbound(_inbound);
+                _parent->Inbound(_inbound, _key);
             }
 
         private:
             const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> _inbound;
+            const AtomId _key;
             class Transport *_parent;
         };
 
-        class ConnectionJob : public WPEFramework::Core::IDispatch
+        // Notifications of one event, queued in arrival order and delivered by one job at a time,
+        // so that they neither overlap nor get reordered while other events run in parallel.
+        // A strand also runs tasks posted for its event, in order with the notifications.
+        struct Strand
+        {
+            struct Item
+            {
+                WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> message;
+                std::function<void()> task;
+            };
+
+            Strand(const AtomId key, class Transport *owner)
+                : event(key)
+                , parent(owner)
+            {
+            }
+
+            const AtomId event;
+            WPEFramework::Core::CriticalSection lock;
+            std::deque<Item> items;
+            // Notifications among the items, the rest are tasks
+            uint32_t messages = 0;
+            bool scheduled = false;
+            // Null once the transport is going away, jobs still queued then do nothing
+            class Transport *parent;
+            // Set while a job drains the strand, the transport waits for it before going away
+            bool draining = false;
+        };
+
+        class StrandJob : public TrackedJob
+        {
+        protected:
+            StrandJob(const std::shared_ptr<Strand> &strand)
+                : TrackedJob(JobKind::Communication), _strand(strand)
+            {
+            }
+
+        public:
+            StrandJob() = delete;
+            StrandJob(const StrandJob &) = delete;
+            StrandJob &operator=(const StrandJob &) = delete;
+
+            ~StrandJob() = default;
+
+        public:
+            void Run() override
+            {
+                _strand->lock.Lock();
+                class Transport *parent = _strand->parent;
+                _strand->draining = (parent != nullptr);
+                _strand->lock.Unlock();
+
+                _drainer = _strand.get();
+                bool done = ((parent == nullptr) || (parent->Drain(_strand) == true));
+                _drainer = nullptr;
+                if (done == false) {
+                    // Still busy, queue up behind the other jobs rather than holding on to the thread
+                    TrackedJob::Submit(WPEFramework::Core::ProxyType<StrandJob>::Create(_strand));
+                }
+            }
+
+        private:
+            const std::shared_ptr<Strand> _strand;
+        };
+
+        class ConnectionJob : public TrackedJob
         {
         protected:
             ConnectionJob(class Transport *parent)
-                : _parent(parent)
+                : TrackedJob(JobKind::Connection), _parent(parent)
             {
             }
 
@@ -100,7 +184,7 @@ namespace FireboltSDK::Transport
         public:
             static WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> Create(class Transport *parent);
 
-            void Dispatch() override
+            void Run() override
             {
                 if (Firebolt::Error::None != _parent->WaitForLinkReady())
                 {
@@ -135,6 +219,7 @@ namespace FireboltSDK::Transport
             : _adminLock()
             , _connectId(WPEFramework::Core::NodeId(url.Host().Value().c_str(), url.Port().Value()))
             , _channel(Channel::Instance(_connectId, ((url.Path().Value().rfind(PathPrefix, 0) == 0) ? url.Path().Value() : string(PathPrefix + url.Path().Value())), url.Query().Value(), true))
+            , _transportReceiver(nullptr)
             , _pendingQueue()
             , _scheduledTime(0)
             , _waitTime(waitTime)
@@ -143,15 +228,25 @@ namespace FireboltSDK::Transport
             , _status(Firebolt::Error::NotConnected)
         {
             _channel->Register(*this);
-            _job = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Transport::ConnectionJob>::Create(this));
-            WPEFramework::Core::IWorkerPool::Instance().Submit(_job);
+            _job = WPEFramework::Core::ProxyType<Transport::ConnectionJob>::Create(this);
+            TrackedJob::Submit(_job);
         }
 
         virtual ~Transport()
         {
-            WPEFramework::Core::IWorkerPool::Instance().Revoke(_job);
+            TrackedJob::Revoke(_job);
             _channel->Unregister(*this);
 
+            // Nothing is queued on the strands anymore, the jobs left become no-ops
+            std::unordered_map<AtomId, std::shared_ptr<Strand>> strands;
+            _strandLock.Lock();
+            _stopping = true;
+            strands.swap(_strands);
+            _strandLock.Unlock();
+            for (auto &entry : strands) {
+                Detach(entry.second);
+            }
+
             for (auto &element : _pendingQueue)
             {
                 element.second.Abort(element.first);
@@ -175,12 +270,13 @@ namespace FireboltSDK::Transport
 
         void Revoke(const string &eventName)
         {
+            AtomId event = Atoms::Instance().Find(eventName);
             _adminLock.Lock();
             // Remove from internal event map
-            _internalEventMap.erase(eventName);
+            _internalEventMap.erase(event);
 
             // Remove from external event map
-            _externalEventMap.erase(eventName);
+            _externalEventMap.erase(event);
             _adminLock.Unlock();
         }
 
@@ -193,6 +289,24 @@ namespace FireboltSDK::Transport
             _transportReceiver = transportReceiver;
         }
 
+        // Inbound messages are handed to the receiver on the socket thread rather than
+        // through the worker pool, for receivers which only queue them up
+        void SetInlineReceive(const bool inlineReceive)
+        {
+            _inlineReceive = inlineReceive;
+        }
+
+        // Runs 'task' on the strand of 'event', after the notifications of it already received
+        void Post(const AtomId event, std::function<void()> &&task)
+        {
+            if (_inlineReceive == true) {
+                // No strands, notifications are handed over on the socket thread
+                task();
+                return;
+            }
+            Enqueue(event, typename Strand::Item{ WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message>(), std::move(task) });
+        }
+
 // Invoke method is overriden for unit testing to call MockResponse method from JSON engine
 #ifdef UNIT_TEST
         template <typename PARAMETERS, typename RESPONSE>
@@ -305,50 +419,39 @@ namespace FireboltSDK::Transport
             return (((waiting == 0) || (IsOpen() == true)) ? Firebolt::Error::None : Firebolt::Error::Timedout);
         }
 
+        // Sends a response given as a JSON-RPC message carrying either 'result' or 'error'
         Firebolt::Error SendResponse(const uint32_t &id, const std::string &response)
         {
-            if (!_channel.IsValid()) {
-                return FireboltErrorValue(WPEFramework::Core::ERROR_UNAVAILABLE);
-            }
-
-            if (_channel->IsSuspended()) {
-                return FireboltErrorValue(WPEFramework::Core::ERROR_ASYNC_FAILED);
-            }
-
             WPEFramework::Core::JSONRPC::Message msg;
             msg.FromString(response);
 
-            WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> message(Channel::Message());
-            message->Id = id;
-            message->Result = msg.Result.Value();
-            if (msg.Error.IsSet()) {
-                message->Error = msg.Error;
-            }
-
-            _adminLock.Lock();
-
-            typename std::pair<typename PendingMap::iterator, bool> newElement =
-                _pendingQueue.emplace(std::piecewise_construct,
-                                      std::forward_as_tuple(id),
-                                      std::forward_as_tuple());
-
-            _adminLock.Unlock();
-
-            ASSERT(newElement.second == true);
-
-            if (!newElement.second) {
-                message.Release();
-                return FireboltErrorValue(WPEFramework::Core::ERROR_ASYNC_FAILED);
-            }
+            return SendReply(id, [&msg](WPEFramework::Core::JSONRPC::Message& message) {
+                message.Result = msg.Result.Value();
+                if (msg.Error.IsSet()) {
+                    message.Error = msg.Error;
+                }
+            });
+        }
 
-            _channel->Submit(WPEFramework::Core::ProxyType<INTERFACE>(message));
+        // Sends 'result', an already serialized JSON value, as the response
+        Firebolt::Error SendResult(const uint32_t &id, const std::string &result)
+        {
+            return SendReply(id, [&result](WPEFramework::Core::JSONRPC::Message& message) {
+                message.Result = result;
+            });
+        }
 
-            message.Release();
-            return Firebolt::Error::None;
+        Firebolt::Error SendError(const uint32_t &id, const int32_t code, const std::string &text)
+        {
+            return SendReply(id, [code, &text](WPEFramework::Core::JSONRPC::Message& message) {
+                message.Error.Code = code;
+                message.Error.Text = text;
+            });
         }
 
+        // Requests whose response is handled by the transport receiver take no 'pending' slot
         template <typename PARAMETERS>
-        Firebolt::Error Send(const string &method, const PARAMETERS &parameters, const uint32_t &id)
+        Firebolt::Error Send(const string &method, const PARAMETERS &parameters, const uint32_t &id, const bool pending = true)
         {
             int32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
 
@@ -366,6 +469,14 @@ namespace FireboltSDK::Transport
                 message->Designator = method;
                 ToMessage(parameters, message);
 
+                if (pending == false)
+                {
+                    _channel->Submit(WPEFramework::Core::ProxyType<INTERFACE>(message));
+
+                    message.Release();
+                    return Firebolt::Error::None;
+                }
+
                 _adminLock.Lock();
 
                 typename std::pair<typename PendingMap::iterator, bool> newElement =
@@ -388,7 +499,51 @@ namespace FireboltSDK::Transport
             return FireboltErrorValue(result);
         }
 
+        // Sends a notification, a message without an id that gets no response
+        template <typename PARAMETERS>
+        Firebolt::Error SendNotification(const string &method, const PARAMETERS &parameters)
+        {
+            if (!_channel.IsValid()) {
+                return FireboltErrorValue(WPEFramework::Core::ERROR_UNAVAILABLE);
+            }
+
+            if (_channel->IsSuspended()) {
+                return FireboltErrorValue(WPEFramework::Core::ERROR_ASYNC_FAILED);
+            }
+
+            WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> message(Channel::Message());
+            message->Designator = method;
+            ToMessage(parameters, message);
+
+            _channel->Submit(WPEFramework::Core::ProxyType<INTERFACE>(message));
+
+            message.Release();
+            return Firebolt::Error::None;
+        }
+
     private:
+        template <typename FILL>
+        Firebolt::Error SendReply(const uint32_t &id, FILL&& fill)
+        {
+            if (!_channel.IsValid()) {
+                return FireboltErrorValue(WPEFramework::Core::ERROR_UNAVAILABLE);
+            }
+
+            if (_channel->IsSuspended()) {
+                return FireboltErrorValue(WPEFramework::Core::ERROR_ASYNC_FAILED);
+            }
+
+            // A response is not answered, so unlike requests it takes no slot in the pending queue
+            WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> message(Channel::Message());
+            message->Id = id;
+            fill(*message);
+
+            _channel->Submit(WPEFramework::Core::ProxyType<INTERFACE>(message));
+
+            message.Release();
+            return Firebolt::Error::None;
+        }
+
         friend Channel;
         inline bool IsEvent(const uint32_t id, string& eventName)
         {
@@ -403,7 +558,7 @@ namespace FireboltSDK::Transport
             for (const auto* map : maps) {
                 for (const auto& event : *map) {
                     if (event.second == id) {
-                        eventName = event.first;
+                        eventName = Atoms::Instance().Name(event.first);
                         eventExist = true;
                         break; // Break the inner loop
                     }
@@ -478,26 +633,157 @@ namespace FireboltSDK::Transport
 
         int32_t Submit(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &inbound)
         {
-            int32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
-            WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> job = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Transport::CommunicationJob>::Create(inbound, this));
-            WPEFramework::Core::IWorkerPool::Instance().Submit(job);
+            Frame frame(*inbound);
+            if ((_transportReceiver != nullptr) && (_transportReceiver->Wanted(frame) == false)) {
+                // Nobody is waiting for it, dropped before anything is queued
+                return 0;
+            }
+            // Events and provider requests are routed by the id of their method, only looked up here
+            AtomId key = (frame.Type() != Frame::Kind::Response) ? frame.Key() : InvalidAtom;
+            if (_inlineReceive == true) {
+                Inbound(inbound, key);
+                return 0;
+            }
+            if ((frame.Type() == Frame::Kind::Event) && (key != InvalidAtom)) {
+                Enqueue(key, inbound);
+                return 0;
+            }
+            TrackedJob::Submit(WPEFramework::Core::ProxyType<Transport::CommunicationJob>::Create(inbound, key, this));
             return 0;
         }
 
-        int32_t Inbound(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &inbound)
+        void Enqueue(const AtomId event, const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &inbound)
+        {
+            Enqueue(event, typename Strand::Item{ inbound, nullptr });
+        }
+
+        void Enqueue(const AtomId event, typename Strand::Item &&item)
+        {
+            _strandLock.Lock();
+            if (_stopping == true) {
+                _strandLock.Unlock();
+                return;
+            }
+            std::shared_ptr<Strand> &entry = _strands[event];
+            if (entry == nullptr) {
+                entry = std::make_shared<Strand>(event, this);
+            }
+            std::shared_ptr<Strand> strand = entry;
+            // Queued before the map is unlocked, so that a drained strand is not dropped from it
+            // with an item on its way, which would then be delivered by a second strand
+            strand->lock.Lock();
+            _strandLock.Unlock();
+
+            if (item.task == nullptr) {
+                ++strand->messages;
+            }
+            strand->items.push_back(std::move(item));
+            bool schedule = (strand->scheduled == false);
+            strand->scheduled = true;
+            strand->lock.Unlock();
+
+            if (schedule == true) {
+                TrackedJob::Submit(WPEFramework::Core::ProxyType<Transport::StrandJob>::Create(strand));
+            }
+        }
+
+        // Returns false when the strand still has items after a batch, its job is then queued again
+        bool Drain(const std::shared_ptr<Strand> &strand)
+        {
+            for (uint8_t count = 0; count < StrandBatch;) {
+                strand->lock.Lock();
+                if (strand->parent == nullptr) {
+                    // Detached by the transport going away from within this very drain
+                    strand->draining = false;
+                    strand->lock.Unlock();
+                    return true;
+                }
+                if (strand->items.empty() == true) {
+                    strand->lock.Unlock();
+                    if (Retire(strand) == true) {
+                        return true;
+                    }
+                    continue;
+                }
+                ++count;
+                typename Strand::Item item = std::move(strand->items.front());
+                strand->items.pop_front();
+                if (item.task == nullptr) {
+                    --strand->messages;
+                }
+                bool superseded = (strand->messages != 0);
+                strand->lock.Unlock();
+
+                if (item.task != nullptr) {
+                    item.task();
+                } else {
+                    Inbound(item.message, strand->event, superseded);
+                }
+            }
+            // Nothing of the transport is to be touched once 'draining' is cleared
+            strand->lock.Lock();
+            strand->draining = false;
+            strand->lock.Unlock();
+            return false;
+        }
+
+        // Ends the drain of an empty strand, unless an item came in meanwhile. The strand is
+        // dropped from the map unless its event has subscribers, more notifications are likely.
+        bool Retire(const std::shared_ptr<Strand> &strand)
+        {
+            bool subscribed = ((_transportReceiver != nullptr) && (_transportReceiver->Subscribed(strand->event) == true));
+
+            _strandLock.Lock();
+            strand->lock.Lock();
+            bool idle = strand->items.empty();
+            if (idle == true) {
+                strand->scheduled = false;
+                if ((subscribed == false) && (_stopping == false)) {
+                    typename std::unordered_map<AtomId, std::shared_ptr<Strand>>::iterator index = _strands.find(strand->event);
+                    if ((index != _strands.end()) && (index->second == strand)) {
+                        _strands.erase(index);
+                    }
+                }
+            }
+            _strandLock.Unlock();
+            // Last, the transport may be gone as soon as the strand is unlocked
+            strand->draining = (idle == false);
+            strand->lock.Unlock();
+            return idle;
+        }
+
+        // Waits for a drain in progress, unless it is the caller's own
+        void Detach(const std::shared_ptr<Strand> &strand)
+        {
+            strand->lock.Lock();
+            strand->parent = nullptr;
+            strand->items.clear();
+            strand->messages = 0;
+            while ((strand->draining == true) && (_drainer != strand.get())) {
+                strand->lock.Unlock();
+                SleepMs(1);
+                strand->lock.Lock();
+            }
+            strand->lock.Unlock();
+        }
+
+        int32_t Inbound(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &inbound, const AtomId key, const bool superseded = false)
         {
             int32_t result = WPEFramework::Core::ERROR_INVALID_SIGNATURE;
 
             ASSERT(inbound.IsValid() == true);
 
             if (_transportReceiver != nullptr) {
-                _transportReceiver->Receive(*inbound);
+                Frame frame(*inbound, key);
+                _transportReceiver->Receive(frame, superseded);
             }
 
             return (result);
         }
 
         static constexpr uint32_t WAITSLOT_TIME = 100;
+        // Notifications a strand delivers before yielding its thread
+        static constexpr uint8_t StrandBatch = 16;
     public:
         void FromMessage(WPEFramework::Core::JSON::IElement *response, const WPEFramework::Core::JSONRPC::Message &message) const
         {
@@ -577,6 +863,13 @@ namespace FireboltSDK::Transport
         WPEFramework::Core::NodeId _connectId;
         WPEFramework::Core::ProxyType<Channel> _channel;
         ITransportReceiver *_transportReceiver;
+        WPEFramework::Core::CriticalSection _strandLock;
+        std::unordered_map<AtomId, std::shared_ptr<Strand>> _strands;
+        // Guarded by _strandLock, set once the transport is going away
+        bool _stopping = false;
+        // Strand the calling thread is draining
+        static inline thread_local const Strand *_drainer = nullptr;
+        std::atomic<bool> _inlineReceive { false };
         PendingMap _pendingQueue;
         EventMap _internalEventMap;
         EventMap _externalEventMap;
@@ -586,6 +879,6 @@ namespace FireboltSDK::Transport
         Listener _listener;
         bool _connected;
         Firebolt::Error _status;
-        WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> _job;
+        WPEFramework::Core::ProxyType<ConnectionJob> _job;
     };
 }
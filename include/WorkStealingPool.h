@@ -0,0 +1,138 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Module.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <vector>
+
+namespace FireboltSDK::Transport {
+
+    // Thread pool where every worker has its own deque of jobs. Jobs submitted from outside
+    // of the pool go to an unbounded injection queue, so producers such as the socket thread
+    // never block on a full queue; jobs submitted by a worker stay on its deque. Idle workers
+    // take from the injection queue first, then steal from the back of the other deques.
+    class WorkStealingPool {
+    public:
+        // The pool grows from its initial thread count up to MaxThreads while jobs wait for
+        // longer than SpawnThreshold ms, and threads above the initial count retire after
+        // IdleTimeout ms without work. The pool is fixed when MaxThreads is not above the
+        // initial count.
+        struct Elasticity {
+            uint8_t MaxThreads = 0;
+            uint32_t SpawnThreshold = 50;
+            uint32_t IdleTimeout = 10000;
+        };
+
+        struct Sizing {
+            uint8_t Min = 0;
+            uint8_t Max = 0;
+            uint8_t Current = 0;
+            uint64_t Spawned = 0;
+            uint64_t Retired = 0;
+        };
+
+    private:
+        using Job = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>;
+        using Clock = std::chrono::steady_clock;
+
+        struct Entry {
+            Job job;
+            Clock::time_point enqueued;
+        };
+
+        struct Worker {
+            std::mutex lock;
+            std::deque<Entry> jobs;
+            // Job being dispatched, guarded by the pool's _runningLock
+            Job running;
+            // Guarded by the pool's _idleLock, 'started' until the thread is joined and
+            // 'active' until it leaves its loop
+            pthread_t thread;
+            bool started = false;
+            bool active = false;
+        };
+
+    public:
+        WorkStealingPool() = delete;
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        WorkStealingPool(const uint8_t threads, const uint32_t stackSize, WPEFramework::Core::ThreadPool::IDispatcher* dispatcher, const Elasticity& elasticity);
+        ~WorkStealingPool();
+
+    public:
+        void Run();
+        void Stop();
+
+        void Submit(const Job& job);
+        uint32_t Revoke(const Job& job, const uint32_t waitTime);
+
+        Sizing Size() const;
+
+    private:
+        static void* Process(void* argument);
+        void Process(const uint8_t index);
+
+        bool Take(const uint8_t index, Entry& entry);
+        bool Remove(const Job& job);
+        void WakeOne();
+
+        bool IsElastic() const
+        {
+            return (_workers.size() > _minThreads);
+        }
+        void Grow();
+        // With _idleLock taken
+        void Spawn();
+
+    private:
+        WPEFramework::Core::ThreadPool::IDispatcher* _dispatcher;
+        uint32_t _stackSize;
+        const uint8_t _minThreads;
+        const std::chrono::milliseconds _spawnThreshold;
+        const std::chrono::milliseconds _idleTimeout;
+        // One per thread the pool may grow to
+        std::vector<std::unique_ptr<Worker>> _workers;
+
+        std::mutex _injectionLock;
+        std::deque<Entry> _injection;
+
+        // Jobs queued anywhere, lets idle workers sleep without scanning all the deques
+        std::atomic<uint32_t> _pending;
+        std::mutex _idleLock;
+        std::condition_variable _idle;
+        bool _running;
+        uint8_t _idleCount;
+        std::atomic<uint8_t> _activeCount;
+        std::atomic<uint64_t> _spawned;
+        std::atomic<uint64_t> _retired;
+
+        std::mutex _runningLock;
+        std::condition_variable _finished;
+    };
+}
@@ -19,6 +19,11 @@
 #pragma once
 
 #include "Module.h"
+#include "ThreadSettings.h"
+#include "WorkStealingPool.h"
+#include "WorkerPoolStatistics.h"
+
+#include <memory>
 
 namespace FireboltSDK::Transport {
 
@@ -28,8 +33,22 @@ namespace FireboltSDK::Transport {
         WorkerPoolImplementation(const WorkerPoolImplementation&) = delete;
         WorkerPoolImplementation& operator=(const WorkerPoolImplementation&) = delete;
 
-        WorkerPoolImplementation(const uint8_t threads, const uint32_t stackSize, const uint32_t queueSize)
-            : WorkerPool(threads, stackSize, queueSize, &_dispatcher)
+        enum class Scheduler {
+            // A single queue shared by all the threads
+            Shared,
+            // See WorkStealingPool
+            WorkStealing
+        };
+
+        // Only the work-stealing scheduler can be elastic
+        WorkerPoolImplementation(const uint8_t threads, const uint32_t stackSize, const uint32_t queueSize, const Scheduler scheduler = Scheduler::Shared,
+                                 const WorkStealingPool::Elasticity& elasticity = WorkStealingPool::Elasticity(), const ThreadSettings& settings = ThreadSettings())
+            // The base pool only runs the timer of Schedule() for the work-stealing scheduler, no thread of its own
+            : WorkerPool((scheduler == Scheduler::WorkStealing ? 0 : threads), stackSize, queueSize, &_dispatcher)
+            , _threads(threads)
+            , _monitor()
+            , _dispatcher(_monitor, settings)
+            , _workStealing(scheduler == Scheduler::WorkStealing ? new WorkStealingPool(threads, stackSize, &_dispatcher, elasticity) : nullptr)
         {
         }
 
@@ -42,12 +61,52 @@ namespace FireboltSDK::Transport {
     public:
         void Stop()
         {
-            WPEFramework::Core::WorkerPool::Stop();
+            if (_workStealing != nullptr) {
+                _workStealing->Stop();
+            } else {
+                WPEFramework::Core::WorkerPool::Stop();
+            }
         }
 
         void Run()
         {
-            WPEFramework::Core::WorkerPool::Run();
+            if (_workStealing != nullptr) {
+                _workStealing->Run();
+            } else {
+                WPEFramework::Core::WorkerPool::Run();
+            }
+        }
+
+        void Submit(const WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>& job) override
+        {
+            _monitor.Submitted(*job);
+            if (_workStealing != nullptr) {
+                _workStealing->Submit(job);
+            } else {
+                WPEFramework::Core::WorkerPool::Submit(job);
+            }
+        }
+
+        uint32_t Revoke(const WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>& job, const uint32_t waitTime = WPEFramework::Core::infinite) override
+        {
+            _monitor.Revoking(*job);
+            uint32_t result = (_workStealing != nullptr)
+                ? _workStealing->Revoke(job, waitTime)
+                : WPEFramework::Core::WorkerPool::Revoke(job, waitTime);
+            _monitor.Revoked(*job, (result == WPEFramework::Core::ERROR_NONE));
+            return result;
+        }
+
+        WorkerPoolStatistics Statistics() const
+        {
+            WorkerPoolStatistics statistics = _monitor.Statistics();
+            if (_workStealing != nullptr) {
+                WorkStealingPool::Sizing size = _workStealing->Size();
+                statistics.Size = { size.Min, size.Max, size.Current, size.Spawned, size.Retired };
+            } else {
+                statistics.Size = { _threads, _threads, _threads, 0, 0 };
+            }
+            return statistics;
         }
 
     private:
@@ -56,26 +115,47 @@ namespace FireboltSDK::Transport {
             Dispatcher(const Dispatcher&) = delete;
             Dispatcher& operator=(const Dispatcher&) = delete;
 
-            Dispatcher() = default;
+            Dispatcher(WorkerPoolMonitor& monitor, const ThreadSettings& settings)
+                : _monitor(monitor)
+                , _settings(settings)
+                , _started(0)
+            {
+            }
             ~Dispatcher() override = default;
 
         private:
-            void Initialize() override { }
-            void Deinitialize() override { }
+            // Runs on every pool thread as it starts
+            void Initialize() override
+            {
+                _settings.Apply(_started.fetch_add(1, std::memory_order_relaxed));
+                _monitor.ThreadStarted();
+            }
+            void Deinitialize() override
+            { _monitor.ThreadStopped(); }
             void Dispatch(WPEFramework::Core::IDispatch* job) override
-            { job->Dispatch(); }
+            { _monitor.Dispatch(*job); }
+
+        private:
+            WorkerPoolMonitor& _monitor;
+            const ThreadSettings _settings;
+            std::atomic<uint8_t> _started;
         };
 
+        uint8_t _threads;
+        WorkerPoolMonitor _monitor;
         Dispatcher _dispatcher;
+        // Replaces the threads of the base pool when set
+        std::unique_ptr<WorkStealingPool> _workStealing;
     };
 
-    class Worker : public WPEFramework::Core::IDispatch {
+    class Worker : public TrackedJob {
     public:
         typedef std::function<void(const void*)> Dispatcher;
 
     protected:
         Worker(const Dispatcher& dispatcher, const void* userData)
-            : _dispatcher(dispatcher)
+            : TrackedJob(JobKind::Worker)
+            , _dispatcher(dispatcher)
             , _userData(userData)
         {
         }
@@ -90,7 +170,7 @@ namespace FireboltSDK::Transport {
     public:
         static WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> Create(const Dispatcher& dispatcher, const void* userData);
 
-        void Dispatch() override
+        void Run() override
         {
             _dispatcher(_userData);
         }
@@ -0,0 +1,417 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Module.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace FireboltSDK::Transport {
+
+    enum class JobKind : uint8_t {
+        Communication,
+        Connection,
+        Async,
+        Worker,
+        // Jobs not derived from TrackedJob, only their run time is known
+        Other,
+        Count
+    };
+
+    // Base of the jobs submitted to the worker pool, carries what the pool needs to tell
+    // how long the job waited and what kind of job it was. Submitted and revoked through
+    // Submit() and Revoke(), which tag it for the pool; jobs implement Run().
+    class TrackedJob : public WPEFramework::Core::IDispatch {
+    public:
+        // Told by a tracked job as it starts, on the thread the monitor dispatches it on
+        struct IMonitor {
+            virtual ~IMonitor() = default;
+            virtual void Started(TrackedJob& job) = 0;
+        };
+
+    protected:
+        TrackedJob(const JobKind kind)
+            : _kind(kind)
+            , _enqueued(0)
+            , _queued(false)
+        {
+        }
+
+        virtual void Run() = 0;
+
+    public:
+        template <typename JOB>
+        static void Submit(const WPEFramework::Core::ProxyType<JOB>& job)
+        {
+            static_assert(std::is_base_of<TrackedJob, JOB>::value, "Only for tracked jobs");
+            _tagged = &(*job);
+            WPEFramework::Core::IWorkerPool::Instance().Submit(WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(job));
+            _tagged = nullptr;
+        }
+
+        template <typename JOB>
+        static uint32_t Revoke(const WPEFramework::Core::ProxyType<JOB>& job, const uint32_t waitTime = WPEFramework::Core::infinite)
+        {
+            static_assert(std::is_base_of<TrackedJob, JOB>::value, "Only for tracked jobs");
+            _tagged = &(*job);
+            uint32_t result = WPEFramework::Core::IWorkerPool::Instance().Revoke(WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(job), waitTime);
+            _tagged = nullptr;
+            return result;
+        }
+
+        // The tracked job 'job' is, when it is being submitted or revoked by the calling thread
+        static TrackedJob* Tagged(const WPEFramework::Core::IDispatch& job)
+        {
+            return ((_tagged != nullptr) && (static_cast<const WPEFramework::Core::IDispatch*>(_tagged) == &job)) ? _tagged : nullptr;
+        }
+
+        // Set by the monitor around the dispatch of a job on the calling thread
+        static void Monitor(IMonitor* monitor)
+        {
+            _monitor = monitor;
+        }
+
+        void Dispatch() final
+        {
+            // Only the job dispatched by the pool reports, not those it may run inline
+            IMonitor* monitor = _monitor;
+            _monitor = nullptr;
+            if (monitor != nullptr) {
+                monitor->Started(*this);
+            }
+            Run();
+        }
+
+        JobKind Kind() const
+        {
+            return _kind;
+        }
+
+        void Enqueued(const int64_t now)
+        {
+            _enqueued.store(now, std::memory_order_relaxed);
+            _queued.store(true, std::memory_order_release);
+        }
+
+        // Returns whether the job was still queued, only once per Enqueued()
+        bool Dequeued(int64_t& enqueued)
+        {
+            enqueued = _enqueued.load(std::memory_order_relaxed);
+            return _queued.exchange(false, std::memory_order_acq_rel);
+        }
+
+    private:
+        const JobKind _kind;
+        std::atomic<int64_t> _enqueued;
+        std::atomic<bool> _queued;
+
+        static inline thread_local TrackedJob* _tagged = nullptr;
+        static inline thread_local IMonitor* _monitor = nullptr;
+    };
+
+    // Snapshot of the worker pool activity, durations are in microseconds
+    struct WorkerPoolStatistics {
+        static constexpr uint8_t Buckets = 32;
+
+        struct Histogram {
+            uint64_t Count = 0;
+            uint64_t Sum = 0;
+            uint64_t Max = 0;
+            // Bucket 0 counts durations below 1us, bucket i those in [2^(i-1), 2^i)
+            std::array<uint64_t, Buckets> Counts {};
+        };
+
+        struct Kind {
+            // From Submit() to the start of the dispatch
+            Histogram Wait;
+            Histogram Run;
+        };
+
+        // Per thread slot, a slot freed by a retired thread is taken by the next one started.
+        // The figures are those of the thread in the slot, since it started.
+        struct Thread {
+            bool Active = false;
+            uint64_t Jobs = 0;
+            uint64_t Busy = 0;
+            // Time the thread has been, or was, running for
+            uint64_t Lifetime = 0;
+            // Share of the lifetime spent running jobs
+            double Utilization = 0;
+        };
+
+        // Thread count and how often an elastic pool resized
+        struct Sizing {
+            uint8_t Min = 0;
+            uint8_t Max = 0;
+            uint8_t Current = 0;
+            uint64_t Spawned = 0;
+            uint64_t Retired = 0;
+        };
+
+        std::array<Kind, static_cast<uint8_t>(JobKind::Count)> Kinds;
+        // Jobs of any kind submitted and neither started nor revoked yet
+        uint32_t QueueDepth = 0;
+        uint32_t QueueHighWater = 0;
+        std::vector<Thread> Threads;
+        Sizing Size;
+        uint64_t Uptime = 0;
+    };
+
+    // Collects the statistics, every update is a handful of atomic operations. Only revoking
+    // a job takes a lock, to tell whether it left the queue or was already dispatched.
+    class WorkerPoolMonitor : public TrackedJob::IMonitor {
+    private:
+        static constexpr uint8_t MaxThreads = 64;
+
+        class Histogram {
+        public:
+            void Add(const uint64_t value)
+            {
+                uint8_t bucket = 0;
+                for (uint64_t remaining = value; (remaining != 0) && (bucket < (WorkerPoolStatistics::Buckets - 1)); remaining >>= 1) {
+                    ++bucket;
+                }
+                _counts[bucket].fetch_add(1, std::memory_order_relaxed);
+                _count.fetch_add(1, std::memory_order_relaxed);
+                _sum.fetch_add(value, std::memory_order_relaxed);
+                uint64_t max = _max.load(std::memory_order_relaxed);
+                while ((value > max) && (_max.compare_exchange_weak(max, value, std::memory_order_relaxed) == false)) {
+                }
+            }
+
+            void Read(WorkerPoolStatistics::Histogram& histogram) const
+            {
+                histogram.Count = _count.load(std::memory_order_relaxed);
+                histogram.Sum = _sum.load(std::memory_order_relaxed);
+                histogram.Max = _max.load(std::memory_order_relaxed);
+                for (uint8_t bucket = 0; bucket < WorkerPoolStatistics::Buckets; ++bucket) {
+                    histogram.Counts[bucket] = _counts[bucket].load(std::memory_order_relaxed);
+                }
+            }
+
+        private:
+            std::array<std::atomic<uint64_t>, WorkerPoolStatistics::Buckets> _counts {};
+            std::atomic<uint64_t> _count { 0 };
+            std::atomic<uint64_t> _sum { 0 };
+            std::atomic<uint64_t> _max { 0 };
+        };
+
+        struct Kind {
+            Histogram wait;
+            Histogram run;
+        };
+
+        struct Thread {
+            std::atomic<bool> inUse { false };
+            std::atomic<uint64_t> jobs { 0 };
+            std::atomic<uint64_t> busy { 0 };
+            std::atomic<int64_t> started { 0 };
+            std::atomic<int64_t> stopped { 0 };
+            // Job being dispatched by the thread
+            std::atomic<const WPEFramework::Core::IDispatch*> dispatching { nullptr };
+        };
+
+        // A job being revoked, and whether a thread dispatched it meanwhile
+        struct Revocation {
+            const WPEFramework::Core::IDispatch* job;
+            bool dispatched;
+        };
+
+    public:
+        WorkerPoolMonitor(const WorkerPoolMonitor&) = delete;
+        WorkerPoolMonitor& operator=(const WorkerPoolMonitor&) = delete;
+
+        WorkerPoolMonitor()
+            : _started(Now())
+        {
+        }
+
+        static int64_t Now()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void Submitted(WPEFramework::Core::IDispatch& job)
+        {
+            TrackedJob* tracked = TrackedJob::Tagged(job);
+            if (tracked != nullptr) {
+                tracked->Enqueued(Now());
+            }
+            uint32_t depth = _depth.fetch_add(1, std::memory_order_relaxed) + 1;
+            uint32_t highWater = _highWater.load(std::memory_order_relaxed);
+            while ((depth > highWater) && (_highWater.compare_exchange_weak(highWater, depth, std::memory_order_relaxed) == false)) {
+            }
+        }
+
+        // Called before the pool is asked to revoke 'job', then Revoked() once it returned
+        void Revoking(const WPEFramework::Core::IDispatch& job)
+        {
+            std::lock_guard<std::mutex> lock(_revokingLock);
+            _revoking.push_back({ &job, false });
+            // Either this sees a thread that started dispatching the job, or that thread sees the
+            // revocation in Dispatch()
+            _revokingCount.fetch_add(1, std::memory_order_seq_cst);
+            for (uint8_t index = 0; index < std::min<uint8_t>(_threadCount.load(std::memory_order_relaxed), MaxThreads); ++index) {
+                if (_threads[index].dispatching.load(std::memory_order_seq_cst) == &job) {
+                    _revoking.back().dispatched = true;
+                }
+            }
+        }
+
+        // 'removed' when the pool revoked the job, it then left the queue unless it was dispatched
+        void Revoked(WPEFramework::Core::IDispatch& job, const bool removed)
+        {
+            bool dispatched = false;
+            {
+                std::lock_guard<std::mutex> lock(_revokingLock);
+                auto entry = std::find_if(_revoking.begin(), _revoking.end(), [&job](const Revocation& revocation) { return revocation.job == &job; });
+                if (entry != _revoking.end()) {
+                    dispatched = entry->dispatched;
+                    _revoking.erase(entry);
+                }
+                _revokingCount.fetch_sub(1, std::memory_order_relaxed);
+            }
+            if ((removed == true) && (dispatched == false)) {
+                TrackedJob* tracked = TrackedJob::Tagged(job);
+                int64_t enqueued;
+                if (tracked != nullptr) {
+                    tracked->Dequeued(enqueued);
+                }
+                _depth.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        // Called by each pool thread as it starts, and stops
+        void ThreadStarted()
+        {
+            _thread = nullptr;
+            for (uint8_t index = 0; (index < MaxThreads) && (_thread == nullptr); ++index) {
+                bool inUse = false;
+                if (_threads[index].inUse.compare_exchange_strong(inUse, true, std::memory_order_relaxed) == true) {
+                    _thread = &_threads[index];
+                    _thread->jobs.store(0, std::memory_order_relaxed);
+                    _thread->busy.store(0, std::memory_order_relaxed);
+                    _thread->started.store(Now(), std::memory_order_relaxed);
+                    uint8_t count = _threadCount.load(std::memory_order_relaxed);
+                    while ((count <= index) && (_threadCount.compare_exchange_weak(count, index + 1, std::memory_order_relaxed) == false)) {
+                    }
+                }
+            }
+        }
+
+        void ThreadStopped()
+        {
+            if (_thread != nullptr) {
+                _thread->stopped.store(Now(), std::memory_order_relaxed);
+                _thread->inUse.store(false, std::memory_order_relaxed);
+                _thread = nullptr;
+            }
+        }
+
+        // Runs the job on the calling thread, accounting for it
+        void Dispatch(WPEFramework::Core::IDispatch& job)
+        {
+            if (_thread != nullptr) {
+                _thread->dispatching.store(&job, std::memory_order_seq_cst);
+            }
+            if (_revokingCount.load(std::memory_order_seq_cst) != 0) {
+                std::lock_guard<std::mutex> lock(_revokingLock);
+                for (Revocation& revocation : _revoking) {
+                    revocation.dispatched = (revocation.dispatched == true) || (revocation.job == &job);
+                }
+            }
+            _depth.fetch_sub(1, std::memory_order_relaxed);
+
+            int64_t start = Now();
+            // A tracked job tells its kind through Started()
+            _kind = JobKind::Other;
+            TrackedJob::Monitor(this);
+
+            job.Dispatch();
+
+            TrackedJob::Monitor(nullptr);
+            if (_thread != nullptr) {
+                _thread->dispatching.store(nullptr, std::memory_order_relaxed);
+            }
+            uint64_t duration = Now() - start;
+            _kinds[static_cast<uint8_t>(_kind)].run.Add(duration);
+            if (_thread != nullptr) {
+                _thread->jobs.fetch_add(1, std::memory_order_relaxed);
+                _thread->busy.fetch_add(duration, std::memory_order_relaxed);
+            }
+        }
+
+        void Started(TrackedJob& job) override
+        {
+            _kind = job.Kind();
+            int64_t enqueued;
+            if (job.Dequeued(enqueued) == true) {
+                int64_t start = Now();
+                _kinds[static_cast<uint8_t>(_kind)].wait.Add(start > enqueued ? start - enqueued : 0);
+            }
+        }
+
+        WorkerPoolStatistics Statistics() const
+        {
+            WorkerPoolStatistics statistics;
+            statistics.Uptime = Now() - _started;
+            for (uint8_t kind = 0; kind < static_cast<uint8_t>(JobKind::Count); ++kind) {
+                _kinds[kind].wait.Read(statistics.Kinds[kind].Wait);
+                _kinds[kind].run.Read(statistics.Kinds[kind].Run);
+            }
+            statistics.QueueDepth = _depth.load(std::memory_order_relaxed);
+            statistics.QueueHighWater = _highWater.load(std::memory_order_relaxed);
+            uint8_t threads = std::min<uint8_t>(_threadCount.load(std::memory_order_relaxed), MaxThreads);
+            for (uint8_t index = 0; index < threads; ++index) {
+                WorkerPoolStatistics::Thread thread;
+                thread.Active = _threads[index].inUse.load(std::memory_order_relaxed);
+                thread.Jobs = _threads[index].jobs.load(std::memory_order_relaxed);
+                thread.Busy = _threads[index].busy.load(std::memory_order_relaxed);
+                int64_t until = (thread.Active == true) ? Now() : _threads[index].stopped.load(std::memory_order_relaxed);
+                int64_t started = _threads[index].started.load(std::memory_order_relaxed);
+                thread.Lifetime = (until > started) ? until - started : 0;
+                thread.Utilization = (thread.Lifetime != 0) ? static_cast<double>(thread.Busy) / thread.Lifetime : 0;
+                statistics.Threads.push_back(thread);
+            }
+            return statistics;
+        }
+
+    private:
+        const int64_t _started;
+        std::array<Kind, static_cast<uint8_t>(JobKind::Count)> _kinds;
+        std::atomic<uint32_t> _depth { 0 };
+        std::atomic<uint32_t> _highWater { 0 };
+        std::array<Thread, MaxThreads> _threads;
+        std::atomic<uint8_t> _threadCount { 0 };
+        std::mutex _revokingLock;
+        std::vector<Revocation> _revoking;
+        std::atomic<uint32_t> _revokingCount { 0 };
+
+        static inline thread_local Thread* _thread = nullptr;
+        // Kind of the job the calling thread is dispatching
+        static inline thread_local JobKind _kind = JobKind::Other;
+    };
+}
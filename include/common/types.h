@@ -24,6 +24,7 @@
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 namespace Firebolt
 {
@@ -33,6 +34,7 @@ template <typename T> class Result
 {
 public:
     explicit Result(const T& value) : value_{value}, error_{Error::None} {}
+    explicit Result(T&& value) : value_{std::move(value)}, error_{Error::None} {}
     explicit Result(const Error& error) : value_{}, error_{error} {}
 
     bool has_value() const { return value_.has_value(); }
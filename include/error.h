@@ -30,6 +30,7 @@ enum class Error : int32_t
     Timedout = 2,
     NotConnected = 3,
     AlreadyConnected = 4,
+    Cancelled = 5,
     // AuthenticationError, ?
     InvalidRequest = -32600,
     MethodNotFound = -32601,
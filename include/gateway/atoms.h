@@ -0,0 +1,158 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Portability.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FireboltSDK::Transport
+{
+using AtomId = uint32_t;
+static constexpr AtomId InvalidAtom = 0;
+
+// FNV-1a, usable at compile time so that names known upfront can come with their hash
+constexpr uint64_t AtomHash(std::string_view name)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : name) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Interning table mapping method and event names to compact ids. Names are interned
+// once, when subscribing or registering, and per-message routing then works on ids.
+// Lookups take no lock: the hash table is only ever added to, and replaced by a larger
+// copy when it fills up, so readers see either an entry or an empty slot.
+class FIREBOLTSDK_EXPORT Atoms
+{
+    struct Entry
+    {
+        std::string name;
+        uint64_t hash;
+        AtomId id;
+    };
+
+    // Open addressing, its size is a power of two kept at least twice the entry count
+    struct Table
+    {
+        explicit Table(size_t size) : slots(size) {}
+
+        std::vector<std::atomic<const Entry*>> slots;
+    };
+
+    static constexpr size_t InitialSize = 64;
+
+    // Owns the names, ids are their index + 1
+    std::deque<Entry> entries;
+    std::atomic<const Table*> table;
+    // Every table published, a reader may still be walking an older one
+    std::vector<std::unique_ptr<Table>> tables;
+    mutable std::mutex entries_mtx;
+
+    Atoms()
+    {
+        tables.emplace_back(new Table(InitialSize));
+        table.store(tables.back().get(), std::memory_order_release);
+    }
+
+    static void insert(Table& into, const Entry& entry)
+    {
+        size_t mask = into.slots.size() - 1;
+        size_t slot = entry.hash & mask;
+        while (into.slots[slot].load(std::memory_order_relaxed) != nullptr) {
+            slot = (slot + 1) & mask;
+        }
+        into.slots[slot].store(&entry, std::memory_order_release);
+    }
+
+public:
+    Atoms(const Atoms&) = delete;
+    Atoms& operator=(const Atoms&) = delete;
+
+    static Atoms& Instance();
+
+    AtomId Intern(std::string_view name)
+    {
+        return Intern(name, AtomHash(name));
+    }
+
+    AtomId Intern(std::string_view name, uint64_t hash)
+    {
+        AtomId id = Find(name, hash);
+        if (id != InvalidAtom) {
+            return id;
+        }
+        std::lock_guard lck(entries_mtx);
+        id = Find(name, hash);
+        if (id == InvalidAtom) {
+            id = static_cast<AtomId>(entries.size() + 1);
+            entries.push_back(Entry{ std::string(name), hash, id });
+            const Table* current = table.load(std::memory_order_relaxed);
+            if (entries.size() * 2 > current->slots.size()) {
+                tables.emplace_back(new Table(current->slots.size() * 2));
+                for (const Entry& entry : entries) {
+                    insert(*tables.back(), entry);
+                }
+                table.store(tables.back().get(), std::memory_order_release);
+            } else {
+                insert(*tables.back(), entries.back());
+            }
+        }
+        return id;
+    }
+
+    // Returns InvalidAtom for names never interned, without allocating
+    AtomId Find(std::string_view name) const
+    {
+        return Find(name, AtomHash(name));
+    }
+
+    AtomId Find(std::string_view name, uint64_t hash) const
+    {
+        const Table* current = table.load(std::memory_order_acquire);
+        size_t mask = current->slots.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            const Entry* entry = current->slots[slot].load(std::memory_order_acquire);
+            if (entry == nullptr) {
+                return InvalidAtom;
+            }
+            if (entry->hash == hash && entry->name == name) {
+                return entry->id;
+            }
+        }
+    }
+
+    const std::string& Name(AtomId id) const
+    {
+        static const std::string empty;
+        std::lock_guard lck(entries_mtx);
+        return (id != InvalidAtom && id <= entries.size()) ? entries[id - 1].name : empty;
+    }
+};
+} // namespace Firebolt::Transport
@@ -25,21 +25,29 @@
 #include <core/core.h>
 #include "error.h"
 
+#include "Logger.h"
 #include "Transport.h"
 
 #include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "gateway/common.h"
+#include "gateway/frame.h"
 
 namespace FireboltSDK::Transport
 {
 class Client
 {
+public:
+    using Completion = std::function<void(Firebolt::Error status, const std::string &result)>;
+
+private:
     struct Caller
     {
         Caller(MessageID id_)
@@ -49,21 +57,36 @@ class Client
 
         MessageID id;
         Timestamp timestamp;
+        // Time the response is given before the request is timed out, the watchdog threshold when 0
+        uint64_t timeout_ms = 0;
+#ifdef UNIT_TEST
+        std::string method;
+        JsonObject parameters;
+#endif
         std::string response;
         Firebolt::Error error = Firebolt::Error::None;
         bool ready = false;
         std::mutex mtx;
         std::condition_variable waiter;
+        // Set for requests nobody waits for, called with the outcome instead
+        Completion completion;
     };
 
     std::map <MessageID, std::shared_ptr<Caller>> queue;
     mutable std::mutex queue_mtx;
     Transport<WPEFramework::Core::JSON::IElement>* transport;
     Config config;
+    std::string cancelMethod;
 
     std::atomic<bool> running { false };
     std::thread watchdogThread;
 
+#ifdef UNIT_TEST
+    static inline std::mutex held_mtx;
+    static inline bool holding = false;
+    static inline std::vector<std::function<void()>> held;
+#endif
+
     void watchdog()
     {
         auto watchdogTimer = std::chrono::milliseconds(config.watchdogCycle_ms);
@@ -74,7 +97,8 @@ class Client
             {
                 std::lock_guard lck(queue_mtx);
                 for (auto it = queue.begin(); it != queue.end();) {
-                    if (std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second->timestamp).count() > config.watchdogThreshold_ms) {
+                    uint64_t threshold = (it->second->timeout_ms != 0) ? it->second->timeout_ms : config.watchdogThreshold_ms;
+                    if (std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second->timestamp).count() > threshold) {
                         outdated.push_back(it->second);
                         it = queue.erase(it);
                     } else {
@@ -83,17 +107,27 @@ class Client
                 }
             }
             for (auto &c : outdated) {
-                std::unique_lock<std::mutex> lk(c->mtx);
-                std::cout << "Watchdog : message-id: " << c->id << " - timed out" << std::endl;
-                c->ready = true;
-                c->error = Firebolt::Error::Timedout;
-                c->waiter.notify_one();
+                FIREBOLT_LOG_WARNING(Logger::Category::OpenRPC, Logger::Module<Client>(), "Watchdog : message-id: %u - timed out", c->id);
+                complete(c, Firebolt::Error::Timedout, std::string());
             }
             outdated.clear();
             std::this_thread::sleep_for(watchdogTimer);
         }
     }
 
+    void complete(const std::shared_ptr<Caller> &c, Firebolt::Error error, std::string response)
+    {
+        if (c->completion) {
+            c->completion(error, response);
+            return;
+        }
+        std::unique_lock<std::mutex> lk(c->mtx);
+        c->error = error;
+        c->response = std::move(response);
+        c->ready = true;
+        c->waiter.notify_one();
+    }
+
 public:
     Client(const Config &config_)
       : config(config_)
@@ -107,6 +141,12 @@ public:
         this->transport = transport;
     }
 
+    // Method notified with the id of cancelled requests, none when empty
+    void SetCancelMethod(const std::string &method)
+    {
+        cancelMethod = method;
+    }
+
     virtual ~Client()
     {
         running = false;
@@ -115,70 +155,220 @@ public:
         }
     }
 
+    using PendingRequest = std::shared_ptr<Caller>;
+
 #ifdef UNIT_TEST
+    PendingRequest Send(const std::string &method, const JsonObject &parameters, Firebolt::Error &status, Completion &&completion = nullptr)
+    {
+        PendingRequest c = std::make_shared<Caller>(0);
+        c->method = method;
+        c->parameters = parameters;
+        status = Firebolt::Error::None;
+        if (completion) {
+            {
+                std::lock_guard lck(held_mtx);
+                if (holding) {
+                    held.push_back([this, c, completion = std::move(completion)]() {
+                        std::string result;
+                        Firebolt::Error error = Wait(c, result);
+                        completion(error, result);
+                    });
+                    return c;
+                }
+            }
+            std::string result;
+            Firebolt::Error error = Wait(c, result);
+            completion(error, result);
+        }
+        return c;
+    }
+
+    // The answers to requests sent with a completion are kept back until released, as if
+    // the endpoint took its time, so that they are outstanding together
+    static void HoldAnswers()
+    {
+        std::lock_guard lck(held_mtx);
+        holding = true;
+    }
+
+    // Answers the requests held back, in the order they were sent, on the calling thread
+    static void ReleaseAnswers()
+    {
+        std::vector<std::function<void()>> answers;
+        {
+            std::lock_guard lck(held_mtx);
+            holding = false;
+            answers.swap(held);
+        }
+        for (const std::function<void()> &answer : answers) {
+            answer();
+        }
+    }
+
     template <typename RESPONSE>
-    Firebolt::Error Request(const std::string &method, const JsonObject &parameters, RESPONSE &response)
+    Firebolt::Error Wait(const PendingRequest &c, RESPONSE &response)
     {
-        return transport->Invoke(method, parameters, response);
+        if constexpr (std::is_base_of_v<WPEFramework::Core::JSON::IElement, RESPONSE>) {
+            return transport->Invoke(c->method, c->parameters, response);
+        } else {
+            // Such as Helpers::VectorResult, only parsed from a string
+            std::string result;
+            Firebolt::Error status = Wait(c, result);
+            if (status == Firebolt::Error::None) {
+                response.FromString(result);
+            }
+            return status;
+        }
+    }
+
+    Firebolt::Error Wait(const PendingRequest &c, std::string &response)
+    {
+        WPEFramework::Core::JSON::Variant value;
+        Firebolt::Error status = transport->Invoke(c->method, c->parameters, value);
+        value.ToString(response);
+        return status;
     }
 #else
-    template <typename RESPONSE>
-    Firebolt::Error Request(const std::string &method, const JsonObject &parameters, RESPONSE &response)
+    // Sends a request without waiting for its response, several requests can be in flight
+    // at once and be collected with Wait(). When a 'completion' is given nothing is to be
+    // collected, it is called with the outcome instead.
+    PendingRequest Send(const std::string &method, const JsonObject &parameters, Firebolt::Error &status, Completion &&completion = nullptr)
     {
         if (transport == nullptr) {
-            return Firebolt::Error::NotConnected;
+            status = Firebolt::Error::NotConnected;
+            return nullptr;
         }
         MessageID id = transport->GetNextMessageID();
-        std::shared_ptr<Caller> c = std::make_shared<Caller>(id);
+        PendingRequest c = std::make_shared<Caller>(id);
+        c->completion = std::move(completion);
         {
             std::lock_guard lck(queue_mtx);
             queue[id] = c;
         }
 
-        Firebolt::Error result = transport->Send(method, parameters, id);
+        status = transport->Send(method, parameters, id, false);
+        if (status != Firebolt::Error::None) {
+            std::lock_guard lck(queue_mtx);
+            queue.erase(id);
+            return nullptr;
+        }
+        return c;
+    }
+
+    // Waits for the response of a request issued with Send(), 'response' gets the raw result
+    Firebolt::Error Wait(const PendingRequest &c, std::string &response)
+    {
+        {
+            std::unique_lock<std::mutex> lk(c->mtx);
+            c->waiter.wait(lk, [&]{ return c->ready; });
+        }
+        {
+            std::lock_guard lck(queue_mtx);
+            queue.erase(c->id);
+        }
+        if (c->error != Firebolt::Error::None) {
+            return c->error;
+        }
+        response = std::move(c->response);
+        return Firebolt::Error::None;
+    }
+
+    template <typename RESPONSE>
+    Firebolt::Error Wait(const PendingRequest &c, RESPONSE &response)
+    {
+        std::string result;
+        Firebolt::Error status = Wait(c, result);
+        if (status == Firebolt::Error::None) {
+            response.FromString(result);
+        }
+        return status;
+    }
+#endif
+
+    template <typename RESPONSE>
+    Firebolt::Error Request(const std::string &method, const JsonObject &parameters, RESPONSE &response)
+    {
+        Firebolt::Error result = Firebolt::Error::None;
+        PendingRequest c = Send(method, parameters, result);
         if (result == Firebolt::Error::None) {
-            {
-                std::unique_lock<std::mutex> lk(c->mtx);
-                c->waiter.wait(lk, [&]{ return c->ready; });
-                {
-                    std::lock_guard lck(queue_mtx);
-                    queue.erase(c->id);
-                }
-            }
-            if (c->error == Firebolt::Error::None) {
-                response.FromString(c->response);
-            } else {
-                result = c->error;
-            }
+            result = Wait(c, response);
         }
+        return result;
+    }
 
+    // Sends a request no thread waits for, 'completion' gets the raw result once the
+    // response arrives, or the error if it fails, times out or is cancelled. 'id' allows
+    // to Cancel() it. It times out after 'timeout_ms', or the watchdog threshold when 0.
+    Firebolt::Error RequestAsync(const std::string &method, const JsonObject &parameters, Completion &&completion, MessageID &id, uint64_t timeout_ms = 0)
+    {
+        Firebolt::Error result = Firebolt::Error::None;
+        PendingRequest c = Send(method, parameters, result, std::move(completion));
+        id = (c != nullptr) ? c->id : 0;
+        if (c != nullptr && timeout_ms != 0) {
+            std::lock_guard lck(queue_mtx);
+            c->timeout_ms = timeout_ms;
+        }
         return result;
     }
-#endif
 
-    bool IdRequested(MessageID id)
+    // Gives up on a request, its waiter or completion is released right away with
+    // Cancelled and a late response is dropped. When a cancel method is configured
+    // the endpoint is told as well, so it can stop working on it.
+    void Cancel(MessageID id)
     {
-        std::lock_guard lck(queue_mtx);
-        return queue.find(id) != queue.end();
+        std::shared_ptr<Caller> c;
+        {
+            std::lock_guard lck(queue_mtx);
+            auto it = queue.find(id);
+            if (it == queue.end()) {
+                return;
+            }
+            c = it->second;
+            queue.erase(it);
+        }
+
+        if (!cancelMethod.empty() && transport != nullptr) {
+            transport->SendNotification(cancelMethod, "{\"id\":" + std::to_string(id) + "}");
+        }
+        complete(c, Firebolt::Error::Cancelled, std::string());
     }
 
-    void Response(const WPEFramework::Core::JSONRPC::Message& message)
+    // Responses nobody waits for are reported here, before anything is queued for them
+    bool IdRequested(MessageID id)
     {
-        MessageID id = message.Id.Value();
-        try {
+        {
             std::lock_guard lck(queue_mtx);
-            auto c = queue.at(id);
-            std::unique_lock<std::mutex> lk(c->mtx);
+            if (queue.find(id) != queue.end()) {
+                return true;
+            }
+        }
+        FIREBOLT_LOG_WARNING(Logger::Category::OpenRPC, Logger::Module<Client>(), "No receiver for message-id: %u", id);
+        return false;
+    }
 
-            if (!message.Error.IsSet()) {
-                c->response = message.Result.Value();
-            } else {
-                c->error = static_cast<Firebolt::Error>(message.Error.Code.Value());
+    // The result is only copied once its caller is known
+    void Response(const Frame& frame)
+    {
+        MessageID id = frame.Id();
+        std::shared_ptr<Caller> c;
+        {
+            std::lock_guard lck(queue_mtx);
+            auto it = queue.find(id);
+            if (it == queue.end()) {
+                // Timed out, cancelled or answered since IdRequested() let it through, already reported
+                return;
+            }
+            c = it->second;
+            if (c->completion) {
+                // Nobody is going to collect it
+                queue.erase(it);
             }
-            c->ready = true;
-            c->waiter.notify_one();
-        } catch (const std::out_of_range &e) {
-            std::cout << "No receiver for message-id: " << id << std::endl;
+        }
+
+        if (!frame.Failed()) {
+            complete(c, Firebolt::Error::None, frame.Result());
+        } else {
+            complete(c, static_cast<Firebolt::Error>(frame.ErrorCode()), std::string());
         }
     }
 };
@@ -27,10 +27,32 @@ namespace FireboltSDK::Transport
 using Timestamp = std::chrono::time_point<std::chrono::steady_clock>;
 using MessageID = uint32_t;
 
+struct SubscriptionOptions
+{
+    // Notifications not yet delivered to a busy subscriber are replaced by the newest one,
+    // meant for state updates such as the property-changed events
+    bool conflate = false;
+
+    // The last value of the event is delivered right away to the new subscriber. If none has
+    // been seen yet, the matching property getter is called along with the subscription.
+    bool replay = false;
+
+    // At most 'throttleCount' notifications are delivered per 'throttleInterval', the others
+    // are dropped before their payload is even parsed
+    uint32_t throttleCount = 0;
+    std::chrono::milliseconds throttleInterval { 0 };
+
+    // A notification is delivered only once the event has been quiet for that long, the
+    // newest one replacing those received meanwhile
+    std::chrono::milliseconds debounce { 0 };
+};
+
 struct Config
 {
     static constexpr uint64_t watchdogThreshold_ms = 3000;
     static constexpr uint64_t watchdogCycle_ms = 500;
+    // Threads running the provider requests, see Accessor's "providerThreads"
+    uint32_t providerThreads = 2;
     static constexpr uint32_t DefaultWaitTime = WPEFramework::Core::infinite;
 };
 } // namespace Firebolt::Transport
@@ -0,0 +1,182 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "gateway/atoms.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace FireboltSDK::Transport
+{
+// A name worked out at compile time
+template <size_t N> struct FixedName
+{
+    char data[N + 1] = {};
+
+    constexpr std::string_view view() const { return std::string_view(data, N); }
+};
+
+namespace Names
+{
+constexpr char toUpper(char c)
+{
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+constexpr char toLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Of the first '.', npos if none. A loop rather than std::string_view::find(), which GCC fails
+// to evaluate at compile time once the traits are declared in an unnamed namespace
+constexpr size_t dot(std::string_view name)
+{
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (name[i] == '.') {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// As Properties::EventName(): "module.property" -> "module.onPropertyChanged"
+constexpr size_t propertyEventSize(std::string_view property)
+{
+    size_t pos = dot(property);
+    return (pos == std::string_view::npos || pos + 1 == property.size()) ? property.size() : property.size() + 9;
+}
+
+template <size_t N> constexpr FixedName<N> propertyEvent(std::string_view property)
+{
+    FixedName<N> result;
+    size_t pos = dot(property);
+    if (N == property.size()) {
+        for (size_t i = 0; i < N; ++i) {
+            result.data[i] = property[i];
+        }
+        return result;
+    }
+    size_t out = 0;
+    for (size_t i = 0; i <= pos; ++i) {
+        result.data[out++] = property[i];
+    }
+    result.data[out++] = 'o';
+    result.data[out++] = 'n';
+    result.data[out++] = toUpper(property[pos + 1]);
+    for (size_t i = pos + 2; i < property.size(); ++i) {
+        result.data[out++] = property[i];
+    }
+    for (char c : std::string_view("Changed")) {
+        result.data[out++] = c;
+    }
+    return result;
+}
+
+// As Server::getKeyFromEvent(): "module.onEvent" -> "module.event"
+constexpr bool hasEventPrefix(std::string_view event)
+{
+    size_t pos = dot(event);
+    return (pos != std::string_view::npos && pos + 3 < event.size() && event.substr(pos + 1, 2) == "on");
+}
+
+constexpr size_t eventKeySize(std::string_view event)
+{
+    return hasEventPrefix(event) ? event.size() - 2 : event.size();
+}
+
+template <size_t N> constexpr FixedName<N> eventKey(std::string_view event)
+{
+    FixedName<N> result;
+    bool prefixed = hasEventPrefix(event);
+    size_t pos = dot(event);
+    size_t out = 0;
+    for (size_t i = 0; i < event.size(); ++i) {
+        if (prefixed && (i == pos + 1 || i == pos + 2)) {
+            continue;
+        }
+        result.data[out++] = (prefixed && i == pos + 3) ? toLower(event[i]) : event[i];
+    }
+    return result;
+}
+} // namespace Names
+
+// Describes a method, property or event of a generated SDK, so that all that is derived from
+// its name is worked out at compile time. TRAITS gives the name and the result codec:
+//
+//     struct DeviceName {
+//         static constexpr std::string_view name = "device.name";
+//         using JsonType = WPEFramework::Core::JSON::String;
+//         using PropertyType = std::string;
+//     };
+//     using DeviceNameProperty = PropertyDescriptor<DeviceName>;
+//
+// The event of a property is the one telling it changed, for other methods it is their name.
+template <typename TRAITS, bool PROPERTY> struct Descriptor
+{
+    using JsonType = typename TRAITS::JsonType;
+    using PropertyType = typename TRAITS::PropertyType;
+
+    static constexpr std::string_view Name = TRAITS::name;
+    static constexpr uint64_t NameHash = AtomHash(Name);
+
+private:
+    static constexpr FixedName<PROPERTY ? Names::propertyEventSize(Name) : Name.size()> eventName =
+        Names::propertyEvent<PROPERTY ? Names::propertyEventSize(Name) : Name.size()>(Name);
+
+public:
+    static constexpr std::string_view EventName = eventName.view();
+
+private:
+    static constexpr FixedName<Names::eventKeySize(EventName)> eventKey = Names::eventKey<Names::eventKeySize(EventName)>(EventName);
+
+public:
+    // What the subscribers of the event are routed by
+    static constexpr std::string_view EventKey = eventKey.view();
+    static constexpr uint64_t EventKeyHash = AtomHash(EventKey);
+
+    // Interned on first use only
+    static AtomId Key()
+    {
+        static const AtomId key = Atoms::Instance().Intern(EventKey, EventKeyHash);
+        return key;
+    }
+
+    // For the APIs taking a std::string, built once
+    static const std::string& NameString()
+    {
+        static const std::string name(Name);
+        return name;
+    }
+
+    static const std::string& EventNameString()
+    {
+        static const std::string name(EventName);
+        return name;
+    }
+};
+
+template <typename TRAITS> using PropertyDescriptor = Descriptor<TRAITS, true>;
+// Methods and events
+template <typename TRAITS> using MethodDescriptor = Descriptor<TRAITS, false>;
+} // namespace Firebolt::Transport
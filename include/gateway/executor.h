@@ -0,0 +1,140 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FireboltSDK::Transport
+{
+// A small pool of threads running posted tasks in FIFO order, and scheduled ones once
+// they are due, kept apart from the global worker pool so that slow tasks cannot starve
+// the transport
+class Executor
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+    std::multimap<Clock::time_point, std::function<void()>> scheduled;
+    std::mutex tasks_mtx;
+    std::condition_variable tasks_cv;
+    bool running = true;
+    // Threads wanted, and those to leave once done with their task after shrinking
+    unsigned size = 0;
+    unsigned retiring = 0;
+
+    void worker()
+    {
+        std::unique_lock lck(tasks_mtx);
+        while (running) {
+            if (retiring > 0) {
+                --retiring;
+                // It may have been woken for a task, leave it to another thread
+                tasks_cv.notify_one();
+                return;
+            }
+            std::function<void()> task;
+            if (!tasks.empty()) {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            } else if (!scheduled.empty() && scheduled.begin()->first <= Clock::now()) {
+                task = std::move(scheduled.begin()->second);
+                scheduled.erase(scheduled.begin());
+            } else if (!scheduled.empty()) {
+                tasks_cv.wait_until(lck, scheduled.begin()->first);
+                continue;
+            } else {
+                tasks_cv.wait(lck);
+                continue;
+            }
+            lck.unlock();
+            task();
+            lck.lock();
+        }
+    }
+
+public:
+    Executor(unsigned threadCount)
+    {
+        Resize(threadCount);
+    }
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    virtual ~Executor()
+    {
+        {
+            std::lock_guard lck(tasks_mtx);
+            running = false;
+            tasks.clear();
+            scheduled.clear();
+        }
+        tasks_cv.notify_all();
+        for (auto &t : threads) {
+            if (t.joinable()) {
+                t.join();
+            }
+        }
+    }
+
+    // Threads are added right away, removed ones finish their current task first
+    void Resize(unsigned threadCount)
+    {
+        {
+            std::lock_guard lck(tasks_mtx);
+            for (; size < threadCount; ++size) {
+                threads.emplace_back(&Executor::worker, this);
+            }
+            if (size > threadCount) {
+                retiring += size - threadCount;
+                size = threadCount;
+            }
+        }
+        tasks_cv.notify_all();
+    }
+
+    void Post(std::function<void()>&& task)
+    {
+        {
+            std::lock_guard lck(tasks_mtx);
+            tasks.push_back(std::move(task));
+        }
+        tasks_cv.notify_one();
+    }
+
+    void Schedule(Clock::time_point due, std::function<void()>&& task)
+    {
+        {
+            std::lock_guard lck(tasks_mtx);
+            scheduled.emplace(due, std::move(task));
+        }
+        // Waiting threads have to reconsider the earliest deadline
+        tasks_cv.notify_all();
+    }
+};
+} // namespace Firebolt::Transport
@@ -0,0 +1,132 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#ifndef MODULE_NAME
+#define MODULE_NAME OpenRPCNativeSDK
+#endif
+#include <core/core.h>
+
+#include "gateway/atoms.h"
+
+#include <cstdint>
+#include <string>
+
+namespace FireboltSDK::Transport
+{
+// View of an inbound message, handled in two steps. What it is and who it is for is
+// decided from the fields the channel has split out, without copying anything out of
+// them, so that a message nobody waits for is dropped at that point. Its method and
+// payload are only copied by the consumer that keeps it. The channel has deserialized
+// the whole message by then: what a dropped message is spared is the copies and the
+// worker pool job, not that parse.
+class Frame
+{
+public:
+    enum class Kind : uint8_t
+    {
+        Invalid,
+        Response,
+        Event,
+        Request
+    };
+
+    explicit Frame(const WPEFramework::Core::JSONRPC::Message &message)
+        : message(message)
+        , kind(classify(message))
+    {}
+
+    // With the id of its method looked up already
+    Frame(const WPEFramework::Core::JSONRPC::Message &message, AtomId key)
+        : message(message)
+        , kind(classify(message))
+        , key(key)
+        , keySet(true)
+    {}
+
+    Frame(const Frame&) = delete;
+    Frame& operator=(const Frame&) = delete;
+
+    Kind Type() const { return kind; }
+    uint32_t Id() const { return message.Id.Value(); }
+
+    // Copied once, on first use
+    const std::string& Method() const
+    {
+        if (!methodSet) {
+            method = message.Designator.Value();
+            methodSet = true;
+        }
+        return method;
+    }
+
+    // Interned id of the method, InvalidAtom when nobody ever subscribed to or provides it
+    AtomId Key() const
+    {
+        if (!keySet) {
+            key = Atoms::Instance().Find(Method());
+            keySet = true;
+        }
+        return key;
+    }
+
+    // Raw JSON, copied once, on first use
+    const std::string& Parameters() const
+    {
+        if (!parametersSet) {
+            parameters = message.Parameters.Value();
+            parametersSet = true;
+        }
+        return parameters;
+    }
+
+    const std::string& Result() const
+    {
+        if (!resultSet) {
+            result = message.Result.Value();
+            resultSet = true;
+        }
+        return result;
+    }
+
+    bool Failed() const { return message.Error.IsSet(); }
+    int32_t ErrorCode() const { return message.Error.Code.Value(); }
+
+private:
+    static Kind classify(const WPEFramework::Core::JSONRPC::Message &message)
+    {
+        if (message.Designator.IsSet()) {
+            return message.Id.IsSet() ? Kind::Request : Kind::Event;
+        }
+        return message.Id.IsSet() ? Kind::Response : Kind::Invalid;
+    }
+
+    const WPEFramework::Core::JSONRPC::Message &message;
+    const Kind kind;
+    mutable std::string method;
+    mutable std::string parameters;
+    mutable std::string result;
+    mutable AtomId key = InvalidAtom;
+    mutable bool methodSet = false;
+    mutable bool keySet = false;
+    mutable bool parametersSet = false;
+    mutable bool resultSet = false;
+};
+} // namespace Firebolt::Transport
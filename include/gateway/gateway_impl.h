@@ -31,7 +31,10 @@
 #include "gateway/client.h"
 #include "gateway/server.h"
 
+#include <algorithm>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace FireboltSDK::Transport
 {
@@ -56,12 +59,39 @@ public:
     WPEFramework::Core::JSON::Boolean Listening;
 };
 
+// A subscription whose requests may still be in flight, see GatewayImpl::BeginSubscribe()
+struct PendingSubscription
+{
+    std::string event;
+    AtomId key = InvalidAtom;
+    void* usercb = nullptr;
+    Firebolt::Error status = Firebolt::Error::None;
+    // Of the listen request of the event, null when the subscriber did not get registered
+    std::shared_ptr<ListenState> listenState;
+    // Whether this subscriber sent the listen request, and is to report how it went
+    bool first = false;
+    Client::PendingRequest listen;
+    Client::PendingRequest get;
+};
+
+// See GatewayImpl::BeginUnsubscribe()
+struct PendingUnsubscription
+{
+    Firebolt::Error status = Firebolt::Error::None;
+    Client::PendingRequest listen;
+};
+
 class GatewayImpl : public ITransportReceiver
 {
     Config config;
     Client client;
     Server server;
     Transport<WPEFramework::Core::JSON::IElement>* transport;
+    CompletionQueue* completionQueue = nullptr;
+    // Notifications posted to the completion queue so far, per event. A posted one is
+    // superseded for the conflating subscribers once a newer one follows it.
+    std::unordered_map<AtomId, uint64_t> posted;
+    std::mutex posted_mtx;
 
     std::string jsonObject2String(const JsonObject &obj) {
         std::string s;
@@ -69,6 +99,23 @@ class GatewayImpl : public ITransportReceiver
         return s;
     }
 
+    // "module.onValueChanged" -> "module.value", empty when not a property-changed event
+    static std::string propertyFromEvent(const std::string &event) {
+        static constexpr size_t suffixLength = sizeof("Changed") - 1;
+        size_t dotPos = event.find('.');
+        if (dotPos == std::string::npos || event.size() <= dotPos + 3 + suffixLength
+            || event.compare(dotPos + 1, 2, "on") != 0
+            || event.compare(event.size() - suffixLength, suffixLength, "Changed") != 0) {
+            return std::string();
+        }
+        std::string property;
+        property.reserve(event.size() - 2 - suffixLength);
+        property.append(event, 0, dotPos + 1);
+        property.push_back(std::tolower(event[dotPos + 3]));
+        property.append(event, dotPos + 4, event.size() - suffixLength - dotPos - 4);
+        return property;
+    }
+
 public:
     GatewayImpl()
       : client(config)
@@ -76,31 +123,103 @@ public:
     {
     }
 
+    // At least one, provider requests would never be answered otherwise
+    void SetProviderThreads(uint32_t count)
+    {
+        config.providerThreads = std::max(count, 1u);
+        server.SetProviderThreads(config.providerThreads);
+    }
+
     void TransportUpdated(Transport<WPEFramework::Core::JSON::IElement>* transport)
     {
         this->transport = transport;
         client.SetTransport(transport);
+        server.SetTransport(transport);
         if (transport != nullptr) {
             transport->SetTransportReceiver(this);
         }
     }
 
-    virtual void Receive(const WPEFramework::Core::JSONRPC::Message& message) override
+    // Events and provider requests are then run by whoever drains 'queue', responses to
+    // synchronous requests still wake their caller directly
+    void SetCompletionQueue(CompletionQueue* queue)
     {
-        if (message.Designator.IsSet())
-        { // designator -> method
-            if (message.Id.IsSet()) {
-                server.Request(transport, message.Id.Value(), message.Designator.Value(), message.Parameters.Value());
-            } else {
-                server.Notify(message.Designator.Value(), message.Parameters.Value());
-            }
+        completionQueue = queue;
+        server.SetCompletionQueue(queue);
+    }
+
+    // Called on the socket thread, so only looks up the id or the event
+    virtual bool Wanted(const Frame& frame) override
+    {
+        switch (frame.Type()) {
+        case Frame::Kind::Response:
+            return client.IdRequested(frame.Id());
+        case Frame::Kind::Event:
+            return server.Subscribed(frame.Key());
+        case Frame::Kind::Request:
+            return true;
+        default:
+            return false;
         }
-        else
+    }
+
+    virtual bool Subscribed(const AtomId event) override
+    {
+        return server.Subscribed(event);
+    }
+
+    virtual void Receive(const Frame& frame, const bool superseded) override
+    {
+        if (frame.Type() == Frame::Kind::Event) {
+            notify(frame, superseded);
+        } else {
+            Receive(frame);
+        }
+    }
+
+    virtual void Receive(const Frame& frame) override
+    {
+        switch (frame.Type()) {
+        case Frame::Kind::Request:
+            server.Request(transport, frame.Id(), frame.Key(), frame.Parameters());
+            break;
+        case Frame::Kind::Event:
+            notify(frame, false);
+            break;
+        case Frame::Kind::Response:
+            client.Response(frame);
+            break;
+        default:
+            break;
+        }
+    }
+
+private:
+    // Every notification is posted to the completion queue, the non-conflating subscribers
+    // want them all. Whether it is superseded is only known once the queue gets to it.
+    void notify(const Frame& frame, bool superseded)
+    {
+        if (completionQueue == nullptr) {
+            server.Notify(frame.Key(), frame.Parameters(), superseded);
+            return;
+        }
+        uint64_t sequence;
         {
-            client.Response(message);
+            std::lock_guard lck(posted_mtx);
+            sequence = ++posted[frame.Key()];
         }
+        completionQueue->Post([this, key = frame.Key(), parameters = frame.Parameters(), sequence, superseded]() {
+            server.Notify(key, parameters, superseded || !latest(key, sequence));
+        });
     }
 
+    bool latest(AtomId key, uint64_t sequence)
+    {
+        std::lock_guard lck(posted_mtx);
+        return posted[key] == sequence;
+    }
+
+public:
     template <typename RESPONSE>
     Firebolt::Error Request(const std::string &method, const JsonObject &parameters, RESPONSE &response)
     {
@@ -110,42 +229,139 @@ public:
         return client.Request(method, parameters, response);
     }
 
-    template <typename RESULT, typename CALLBACK>
-    Firebolt::Error Subscribe(const string& event, JsonObject& parameters, const CALLBACK& callback, void* usercb, const void* userdata, bool prioritize = false)
+    Firebolt::Error RequestAsync(const std::string &method, const JsonObject &parameters, Client::Completion &&completion, MessageID &id, uint64_t timeout_ms = 0)
     {
         if (transport == nullptr) {
             return Firebolt::Error::NotConnected;
         }
+        return client.RequestAsync(method, parameters, std::move(completion), id, timeout_ms);
+    }
 
-        Firebolt::Error status = server.Subscribe<RESULT>(event, parameters, callback, usercb, userdata);
-        if (status != Firebolt::Error::None) {
-            return status;
+    void Cancel(MessageID id)
+    {
+        client.Cancel(id);
+    }
+
+    void SetCancelMethod(const std::string &method)
+    {
+        client.SetCancelMethod(method);
+    }
+
+    template <typename RESULT, typename CALLBACK>
+    Firebolt::Error Subscribe(const string& event, JsonObject& parameters, const CALLBACK& callback, void* usercb, const void* userdata, bool prioritize = false, const SubscriptionOptions& options = {})
+    {
+        PendingSubscription pending = BeginSubscribe<RESULT>(event, parameters, callback, usercb, userdata, options);
+        return EndSubscribe(pending);
+    }
+
+    // Registers the subscriber and sends the requests it takes without waiting for their
+    // responses, so that several subscriptions can be in flight at once. EndSubscribe()
+    // is to be called with the result.
+    template <typename RESULT, typename CALLBACK>
+    PendingSubscription BeginSubscribe(const string& event, JsonObject& parameters, const CALLBACK& callback, void* usercb, const void* userdata, const SubscriptionOptions& options = {})
+    {
+        return BeginSubscribe<RESULT>(server.Key(event), event, parameters, callback, usercb, userdata, options);
+    }
+
+    // With the 'key' of the event worked out already, see Descriptor
+    template <typename RESULT, typename CALLBACK>
+    PendingSubscription BeginSubscribe(AtomId key, const string& event, JsonObject& parameters, const CALLBACK& callback, void* usercb, const void* userdata, const SubscriptionOptions& options = {})
+    {
+        PendingSubscription pending;
+        pending.event = event;
+        pending.key = key;
+        pending.usercb = usercb;
+        if (transport == nullptr) {
+            pending.status = Firebolt::Error::NotConnected;
+            return pending;
         }
 
-        parameters.Set(_T("listen"), WPEFramework::Core::JSON::Variant(true));
-        ListeningResponse response;
-        status = client.Request(event, jsonObject2String(parameters), response);
-        if (status == Firebolt::Error::None && (!response.Listening.IsSet() || !response.Listening.Value())) {
-            status == Firebolt::Error::General;
+        bool fetch = false;
+        pending.status = server.Subscribe<RESULT>(key, parameters, callback, usercb, userdata, options, pending.first, fetch, pending.listenState);
+        if (pending.status != Firebolt::Error::None) {
+            return pending;
         }
-        if (status != Firebolt::Error::None) {
-            server.Unsubscribe(event);
+        std::string property = fetch ? propertyFromEvent(event) : std::string();
+
+        // Only the first subscriber of an event asks the endpoint to start listening, the
+        // others wait for its answer in EndSubscribe(). The listen request and the initial
+        // fetch of the value to replay are pipelined.
+        JsonObject getParameters = parameters;
+        if (pending.first) {
+            parameters.Set(_T("listen"), WPEFramework::Core::JSON::Variant(true));
+            pending.listen = client.Send(event, parameters, pending.status);
+        }
+        if (!property.empty() && pending.status == Firebolt::Error::None) {
+            Firebolt::Error getStatus = Firebolt::Error::None;
+            pending.get = client.Send(property, getParameters, getStatus);
+        }
+        return pending;
+    }
+
+    // Subscribers that did not send the listen request wait for the one that did. If it
+    // fails, all the subscribers of the event are removed and fail with it.
+    Firebolt::Error EndSubscribe(PendingSubscription& pending)
+    {
+        Firebolt::Error status = pending.status;
+        if (pending.listen) {
+            ListeningResponse response;
+            status = client.Wait(pending.listen, response);
+            if (status == Firebolt::Error::None && (!response.Listening.IsSet() || !response.Listening.Value())) {
+                status = Firebolt::Error::General;
+            }
+        }
+        if (pending.listenState) {
+            if (pending.first) {
+                server.Listened(pending.key, pending.listenState, status);
+            } else {
+                status = pending.listenState->Wait();
+            }
+        }
+        if (pending.get) {
+            std::string value;
+            if (client.Wait(pending.get, value) == Firebolt::Error::None && status == Firebolt::Error::None) {
+                server.Seed(pending.key, pending.usercb, value);
+            }
         }
         return status;
     }
 
-    Firebolt::Error Unsubscribe(const string& event)
+    Firebolt::Error Unsubscribe(const string& event, void* usercb = nullptr)
     {
-        Firebolt::Error status = server.Unsubscribe(event);
-        if (status != Firebolt::Error::None) {
-            return status;
+        PendingUnsubscription pending = BeginUnsubscribe(event, usercb);
+        return EndUnsubscribe(pending);
+    }
+
+    // The subscriber is gone once it returns, the request telling the endpoint to stop
+    // listening, if it was the last one, is completed by EndUnsubscribe()
+    PendingUnsubscription BeginUnsubscribe(const string& event, void* usercb = nullptr)
+    {
+        return BeginUnsubscribe(server.FindKey(event), event, usercb);
+    }
+
+    PendingUnsubscription BeginUnsubscribe(AtomId key, const string& event, void* usercb = nullptr)
+    {
+        PendingUnsubscription pending;
+        bool last = false;
+        pending.status = server.Unsubscribe(key, usercb, last);
+        if (pending.status != Firebolt::Error::None || !last) {
+            return pending;
         }
         JsonObject parameters;
         parameters.Set(_T("listen"), WPEFramework::Core::JSON::Variant(false));
-        ListeningResponse response;
-        status = client.Request(event, jsonObject2String(parameters), response);
-        if (status == Firebolt::Error::None && (!response.Listening.IsSet() || response.Listening.Value())) {
-            status == Firebolt::Error::General;
+        pending.listen = client.Send(event, parameters, pending.status);
+        return pending;
+    }
+
+    Firebolt::Error EndUnsubscribe(PendingUnsubscription& pending)
+    {
+        Firebolt::Error status = pending.status;
+        if (pending.listen) {
+            ListeningResponse response;
+            status = client.Wait(pending.listen, response);
+            if (status == Firebolt::Error::None && (!response.Listening.IsSet() || response.Listening.Value())) {
+                status = Firebolt::Error::General;
+            }
         }
         return status;
     }
@@ -0,0 +1,160 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace FireboltSDK::Transport
+{
+// Walks the members of a JSON object, handing out the raw text of their names and values
+// without parsing or copying them. Names are given as written, escapes are not resolved.
+class ObjectMembers
+{
+public:
+    explicit ObjectMembers(std::string_view text)
+        : text(text)
+    {
+        skipWhitespace();
+        // Anything but an object has no members
+        if (position < text.size() && text[position] == '{') {
+            ++position;
+        } else {
+            position = text.size();
+            valid = false;
+        }
+    }
+
+    // False once the object ends or text that is not JSON got in the way
+    bool Next(std::string_view &name, std::string_view &value)
+    {
+        skipWhitespace();
+        if (position >= text.size() || text[position] == '}' || text[position] != '"') {
+            valid = valid && position < text.size() && text[position] == '}';
+            position = text.size();
+            return false;
+        }
+        size_t nameEnd = skipString(position);
+        name = text.substr(position + 1, nameEnd - position - 2);
+        position = nameEnd;
+        skipWhitespace();
+        if (position >= text.size() || text[position] != ':') {
+            valid = false;
+            position = text.size();
+            return false;
+        }
+        ++position;
+        skipWhitespace();
+        size_t end = skipValue(position);
+        size_t last = end;
+        while (last > position && isWhitespace(text[last - 1])) {
+            --last;
+        }
+        if (last == position) {
+            valid = false;
+            position = text.size();
+            return false;
+        }
+        value = text.substr(position, last - position);
+        position = (end < text.size() && text[end] == ',') ? (end + 1) : end;
+        return true;
+    }
+
+    // Whether the members walked so far were well-formed
+    bool Valid() const { return valid; }
+
+    // The raw value of the member 'name', empty when there is none
+    static std::string_view Find(std::string_view text, std::string_view name)
+    {
+        ObjectMembers members(text);
+        std::string_view member;
+        std::string_view value;
+        while (members.Next(member, value)) {
+            if (member == name) {
+                return value;
+            }
+        }
+        return std::string_view();
+    }
+
+private:
+    static bool isWhitespace(char c)
+    {
+        return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+    }
+
+    void skipWhitespace()
+    {
+        while (position < text.size() && isWhitespace(text[position])) {
+            ++position;
+        }
+    }
+
+    // Past the closing quote of the string opening at 'from'
+    size_t skipString(size_t from) const
+    {
+        for (size_t i = from + 1; i < text.size(); ++i) {
+            if (text[i] == '\\') {
+                ++i;
+            } else if (text[i] == '"') {
+                return i + 1;
+            }
+        }
+        return text.size();
+    }
+
+    // Where the value starting at 'from' ends, at its ',' or at the closing '}' of the object
+    size_t skipValue(size_t from) const
+    {
+        uint32_t depth = 0;
+        for (size_t i = from; i < text.size(); ++i) {
+            switch (text[i]) {
+            case '"':
+                i = skipString(i) - 1;
+                break;
+            case '{':
+            case '[':
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                if (depth == 0) {
+                    return i;
+                }
+                --depth;
+                break;
+            case ',':
+                if (depth == 0) {
+                    return i;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        return text.size();
+    }
+
+    std::string_view text;
+    size_t position = 0;
+    bool valid = true;
+};
+} // namespace Firebolt::Transport
@@ -26,65 +26,382 @@
 #include "error.h"
 
 #include "Transport.h"
+#include "CompletionQueue.h"
 
-#include <string>
-#include <map>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <list>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
 
+#include "gateway/atoms.h"
 #include "gateway/common.h"
+#include "gateway/executor.h"
+#include "gateway/scanner.h"
 
 namespace FireboltSDK::Transport
 {
+// Completion handle of a provider request. Asynchronous providers keep a copy and
+// reply once, from any thread, when the response is ready. The request parameters
+// handed to a provider are only valid during the call, a provider replying later
+// must keep its own reference to them.
+class ProviderResponder
+{
+    struct State
+    {
+        Transport<WPEFramework::Core::JSON::IElement>* transport;
+        unsigned id;
+        std::atomic<bool> replied { false };
+    };
+
+    std::shared_ptr<State> state;
+
+    // Sends the reply unless one was sent already, only the first one counts
+    template <typename SEND>
+    Firebolt::Error reply(const SEND& send) const
+    {
+        if (state->replied.exchange(true)) {
+            return Firebolt::Error::General;
+        }
+        if (state->transport == nullptr) {
+            return Firebolt::Error::NotConnected;
+        }
+        return send(*state->transport, state->id);
+    }
+
+public:
+    ProviderResponder(Transport<WPEFramework::Core::JSON::IElement>* transport, unsigned id)
+      : state(std::make_shared<State>())
+    {
+        state->transport = transport;
+        state->id = id;
+    }
+
+    // Replies with a JSON-RPC message carrying either 'result' or 'error'. A result is
+    // cut out of it and sent as is, only an error still gets the message parsed.
+    Firebolt::Error Reply(const std::string &response) const
+    {
+        std::string_view result = ObjectMembers::Find(response, "result");
+        if (!result.empty() && ObjectMembers::Find(response, "error").empty()) {
+            return Result(std::string(result));
+        }
+        return reply([&response](Transport<WPEFramework::Core::JSON::IElement>& transport, unsigned id) {
+            return transport.SendResponse(id, response);
+        });
+    }
+
+    // Replies with 'result', the already serialized JSON value, as is
+    Firebolt::Error Result(const std::string &result) const
+    {
+        return reply([&result](Transport<WPEFramework::Core::JSON::IElement>& transport, unsigned id) {
+            return transport.SendResult(id, result);
+        });
+    }
+
+    Firebolt::Error Error(Firebolt::Error code, const std::string &message) const
+    {
+        return reply([code, &message](Transport<WPEFramework::Core::JSON::IElement>& transport, unsigned id) {
+            return transport.SendError(id, static_cast<int32_t>(code), message);
+        });
+    }
+};
+
+// Outcome of the listen request of an event, shared by its subscribers: the first one sends
+// it, those coming while it is in flight wait for it rather than for nothing
+class ListenState
+{
+public:
+    void Resolve(Firebolt::Error result)
+    {
+        {
+            std::lock_guard lck(mtx);
+            status = result;
+            done = true;
+        }
+        resolved.notify_all();
+    }
+
+    Firebolt::Error Wait()
+    {
+        std::unique_lock lck(mtx);
+        resolved.wait(lck, [this]() { return done; });
+        return status;
+    }
+
+private:
+    std::mutex mtx;
+    std::condition_variable resolved;
+    bool done = false;
+    Firebolt::Error status = Firebolt::Error::None;
+};
+
+// Whether the provider request type holds its parameters in a 'Parameters' element, as the
+// generated ones do, so they can be parsed into it as they come
+template <typename REQUEST, typename = void>
+struct HasParameters : std::false_type {};
+
+template <typename REQUEST>
+struct HasParameters<REQUEST, std::void_t<decltype(std::declval<REQUEST&>().Parameters.FromString(std::declval<const std::string&>()))>>
+    : std::true_type {};
+
 class Server
 {
-    using DispatchFunctionEvent = std::function<void(void*, const void*, const string& parameters)>;
+    using ParseFunctionEvent = std::function<std::shared_ptr<void>(const string& parameters)>;
+    using DispatchFunctionEvent = std::function<void(void*, const void*, const std::shared_ptr<void>& parsed)>;
 
     struct CallbackDataEvent {
+        CallbackDataEvent(const ParseFunctionEvent& parser_, const DispatchFunctionEvent& lambda_, const std::type_index& resultType_, void* usercb_, const void* userdata_, const SubscriptionOptions& options_)
+            : parser(parser_)
+            , lambda(lambda_)
+            , resultType(resultType_)
+            , usercb(usercb_)
+            , userdata(userdata_)
+            , options(options_)
+        {}
+
+        const ParseFunctionEvent parser;
         const DispatchFunctionEvent lambda;
+        const std::type_index resultType;
         void* usercb;
         const void* userdata;
+        const SubscriptionOptions options;
+
+        // Held while the user callback runs, so unsubscribing waits for an ongoing delivery
+        std::mutex delivery_mtx;
+        bool active = true;
+        // Set by the first notification delivered, a replay still on its way is then outdated
+        bool notified = false;
+        std::atomic<std::thread::id> deliveringThread { std::thread::id() };
+
+        std::mutex state_mtx;
+
+        // Conflation state, the newest notification not yet picked up by the ongoing delivery
+        bool delivering = false;
+        std::optional<std::string> pending;
+
+        // Throttling window and debouncing state
+        Timestamp windowStart;
+        uint32_t windowCount = 0;
+        Timestamp quietUntil;
+        std::optional<std::string> debounced;
     };
 
-    using EventMap = std::map<std::string, CallbackDataEvent>;
+    using Subscriber = std::shared_ptr<CallbackDataEvent>;
+    using ParsedPayloads = std::vector<std::pair<std::type_index, std::shared_ptr<void>>>;
+
+    struct EventEntry {
+        std::list<Subscriber> subscribers;
+        // Last payload of the event, kept once any of its subscribers asked for a replay
+        bool replay = false;
+        std::optional<std::string> lastValue;
+        // Of the listen request sent by the first subscriber
+        std::shared_ptr<ListenState> listen;
+    };
+
+    using EventMap = std::unordered_map<AtomId, EventEntry>;
 
     EventMap eventMap;
     mutable std::mutex eventMap_mtx;
 
-    using DispatchFunctionProvider = std::function<std::string(const std::string &parameters, void*)>;
+    using DispatchFunctionProvider = std::function<void(const std::string &parameters, void*, const ProviderResponder&)>;
 
     struct Method {
         std::string name;
-        JsonObject parameters;
         DispatchFunctionProvider lambda;
         void* usercb;
     };
 
-    struct Interface {
-        std::string name;
-        std::list<Method> methods;
-    };
+    // Keyed by the atom of "interface.method"
+    using ProviderMap = std::unordered_map<AtomId, std::list<std::shared_ptr<const Method>>>;
 
-    std::map<std::string, Interface> providers;
+    ProviderMap providers;
     mutable std::mutex providers_mtx;
 
     Config config;
+    Executor providerExecutor;
+    // Runs the debounced deliveries
+    Executor timer;
+    // When set, user callbacks run there instead of on the executors
+    CompletionQueue* completionQueue = nullptr;
+    // Replays go through the strand of their event, as notifications do
+    Transport<WPEFramework::Core::JSON::IElement>* transport = nullptr;
 
-    std::string getKeyFromEvent(const std::string &event)
+    // "module.onEvent" -> "module.event", built in a buffer reused by the calling thread
+    static std::string_view keyOf(std::string_view event)
     {
-        std::string key = event;
-        size_t dotPos = key.find('.');
-        if (dotPos != std::string::npos && dotPos + 3 < key.size() && key.substr(dotPos + 1, 2) == "on") {
-            key[dotPos + 3] = std::tolower(key[dotPos + 3]); // make lower-case the first latter after ".on"
-            key.erase(dotPos + 1, 2); // erase "on"
+        size_t dotPos = event.find('.');
+        if (dotPos == std::string_view::npos || dotPos + 3 >= event.size() || event.compare(dotPos + 1, 2, "on") != 0) {
+            return event;
         }
+        static thread_local std::string key;
+        key.assign(event.data(), dotPos + 1);
+        key.push_back(std::tolower(event[dotPos + 3])); // make lower-case the first latter after ".on"
+        key.append(event.data() + dotPos + 4, event.size() - dotPos - 4);
         return key;
     }
 
+    // Parses the parameters of a provider request into 'request', straight into its parameters
+    // element when it has one. Only other types get them wrapped in '{ "parameters": ... }' first,
+    // built in a buffer reused by the calling thread.
+    template <typename REQUEST>
+    static void parseRequest(REQUEST &request, const std::string &parameters)
+    {
+        request.Clear();
+        if constexpr (HasParameters<REQUEST>::value) {
+            request.Parameters.FromString(parameters);
+        } else {
+            static thread_local std::string wrapped;
+            wrapped.assign("{ \"parameters\":");
+            wrapped.append(parameters);
+            wrapped.push_back('}');
+            request.FromString(wrapped);
+        }
+    }
+
+    const std::shared_ptr<void>& parsedFor(const CallbackDataEvent& subscriber, const std::string &parameters, ParsedPayloads& parsed)
+    {
+        // The payload is parsed once per distinct result type and shared by all the subscribers of that type
+        auto it = std::find_if(parsed.begin(), parsed.end(), [&subscriber](const auto &p) { return p.first == subscriber.resultType; });
+        if (it == parsed.end()) {
+            it = parsed.emplace(parsed.end(), subscriber.resultType, subscriber.parser(parameters));
+        }
+        return it->second;
+    }
+
+    void deliver(CallbackDataEvent& subscriber, const std::shared_ptr<void>& parsed, bool replay = false)
+    {
+        std::lock_guard lck(subscriber.delivery_mtx);
+        if (!subscriber.active || (replay && subscriber.notified)) {
+            return;
+        }
+        subscriber.notified = subscriber.notified || !replay;
+        subscriber.deliveringThread = std::this_thread::get_id();
+        subscriber.lambda(subscriber.usercb, subscriber.userdata, parsed);
+        subscriber.deliveringThread = std::thread::id();
+    }
+
+    // Delivers a value the subscriber did not get notified of, on the same path as the
+    // notifications of the event: behind those already received, then on the completion
+    // queue when there is one. It is dropped if a notification made it first.
+    void replay(AtomId key, const Subscriber& subscriber, const std::string& value)
+    {
+        auto task = [this, subscriber, value]() {
+            if (completionQueue != nullptr) {
+                completionQueue->Post([this, subscriber, value]() {
+                    deliver(*subscriber, subscriber->parser(value), true);
+                });
+            } else {
+                deliver(*subscriber, subscriber->parser(value), true);
+            }
+        };
+        if (transport != nullptr) {
+            transport->Post(key, std::move(task));
+        } else {
+            task();
+        }
+    }
+
+    void conflate(CallbackDataEvent& subscriber, const std::string &parameters, ParsedPayloads& parsed)
+    {
+        {
+            std::lock_guard lck(subscriber.state_mtx);
+            if (subscriber.delivering) {
+                // The ongoing delivery picks this one up when done, replacing any older value still waiting
+                subscriber.pending = parameters;
+                return;
+            }
+            subscriber.delivering = true;
+        }
+        deliver(subscriber, parsedFor(subscriber, parameters, parsed));
+
+        std::unique_lock lck(subscriber.state_mtx);
+        while (subscriber.pending.has_value()) {
+            std::string latest = std::move(*subscriber.pending);
+            subscriber.pending.reset();
+            lck.unlock();
+            deliver(subscriber, subscriber.parser(latest));
+            lck.lock();
+        }
+        subscriber.delivering = false;
+    }
+
+    bool admit(CallbackDataEvent& subscriber)
+    {
+        if (subscriber.options.throttleCount == 0) {
+            return true;
+        }
+        Timestamp now = std::chrono::steady_clock::now();
+        std::lock_guard lck(subscriber.state_mtx);
+        if (now - subscriber.windowStart >= subscriber.options.throttleInterval) {
+            subscriber.windowStart = now;
+            subscriber.windowCount = 0;
+        }
+        return subscriber.windowCount++ < subscriber.options.throttleCount;
+    }
+
+    void debounce(const Subscriber& subscriber, const std::string &parameters)
+    {
+        std::lock_guard lck(subscriber->state_mtx);
+        subscriber->quietUntil = std::chrono::steady_clock::now() + subscriber->options.debounce;
+        bool scheduled = subscriber->debounced.has_value();
+        subscriber->debounced = parameters;
+        if (!scheduled) {
+            scheduleDebounced(subscriber, subscriber->quietUntil);
+        }
+    }
+
+    void scheduleDebounced(const Subscriber& subscriber, Timestamp due)
+    {
+        timer.Schedule(due, [this, subscriber]() {
+            std::unique_lock lck(subscriber->state_mtx);
+            if (std::chrono::steady_clock::now() < subscriber->quietUntil) {
+                // Notifications kept coming, wait for the event to quieten down
+                scheduleDebounced(subscriber, subscriber->quietUntil);
+                return;
+            }
+            std::string latest = std::move(*subscriber->debounced);
+            subscriber->debounced.reset();
+            lck.unlock();
+            if (completionQueue != nullptr) {
+                completionQueue->Post([this, subscriber, latest = std::move(latest)]() {
+                    deliver(*subscriber, subscriber->parser(latest));
+                });
+            } else {
+                deliver(*subscriber, subscriber->parser(latest));
+            }
+        });
+    }
+
 public:
     Server(const Config &config_)
       : config(config_)
+      , providerExecutor(config_.providerThreads)
+      , timer(1)
+    {
+    }
+
+    void SetCompletionQueue(CompletionQueue* queue)
+    {
+        completionQueue = queue;
+    }
+
+    void SetProviderThreads(uint32_t count)
+    {
+        providerExecutor.Resize(count);
+    }
+
+    void SetTransport(Transport<WPEFramework::Core::JSON::IElement>* transport_)
     {
+        transport = transport_;
     }
 
     virtual ~Server()
@@ -93,80 +410,252 @@ public:
         eventMap.clear();
     }
 
+    // Id the subscribers of 'event' are kept by, Descriptor::Key() has it worked out upfront
+    AtomId Key(std::string_view event)
+    {
+        return Atoms::Instance().Intern(keyOf(event));
+    }
+
+    // InvalidAtom when nobody ever subscribed to 'event'
+    AtomId FindKey(std::string_view event)
+    {
+        return Atoms::Instance().Find(keyOf(event));
+    }
+
+    template <typename RESULT, typename CALLBACK>
+    Firebolt::Error Subscribe(const std::string& event, JsonObject& parameters, const CALLBACK& callback, void* usercb, const void* userdata, const SubscriptionOptions& options, bool& first, bool& fetch, std::shared_ptr<ListenState>& listen)
+    {
+        return Subscribe<RESULT>(Key(event), parameters, callback, usercb, userdata, options, first, fetch, listen);
+    }
+
     template <typename RESULT, typename CALLBACK>
-    Firebolt::Error Subscribe(const std::string& event, JsonObject& parameters, const CALLBACK& callback, void* usercb, const void* userdata)
+    // 'first' tells whether this is the first subscriber of the event, it is then to send the
+    // listen request and report how it went with Listened(). 'fetch' tells whether it asked
+    // for a replay while no value has been seen yet, see Seed(). 'listen' is the state of the
+    // listen request of the event.
+    Firebolt::Error Subscribe(AtomId key, JsonObject& parameters, const CALLBACK& callback, void* usercb, const void* userdata, const SubscriptionOptions& options, bool& first, bool& fetch, std::shared_ptr<ListenState>& listen)
     {
         Firebolt::Error status = Firebolt::Error::General;
 
         std::function<void(void* usercb, const void* userdata, void* parameters)> actualCallback = callback;
-        DispatchFunctionEvent implementation = [actualCallback](void* usercb, const void* userdata, const string& parameters) {
-            WPEFramework::Core::ProxyType<RESULT>* inbound = new WPEFramework::Core::ProxyType<RESULT>();
-            *inbound = WPEFramework::Core::ProxyType<RESULT>::Create();
+        ParseFunctionEvent parser = [](const string& parameters) -> std::shared_ptr<void> {
+            auto inbound = std::make_shared<WPEFramework::Core::ProxyType<RESULT>>(WPEFramework::Core::ProxyType<RESULT>::Create());
             (*inbound)->FromString(parameters);
-            actualCallback(usercb, userdata, static_cast<void*>(inbound));
+            return inbound;
         };
-        CallbackDataEvent callbackData = {implementation, usercb, userdata};
-
-        std::string key = getKeyFromEvent(event);
+        DispatchFunctionEvent implementation = [actualCallback](void* usercb, const void* userdata, const std::shared_ptr<void>& parsed) {
+            // Each subscriber gets its own reference to the shared payload, it must not be modified
+            WPEFramework::Core::ProxyType<RESULT> inbound(*std::static_pointer_cast<WPEFramework::Core::ProxyType<RESULT>>(parsed));
+            actualCallback(usercb, userdata, static_cast<void*>(&inbound));
+        };
+        Subscriber subscriber = std::make_shared<CallbackDataEvent>(parser, implementation, std::type_index(typeid(RESULT)), usercb, userdata, options);
 
-        std::lock_guard lck(eventMap_mtx);
-        EventMap::iterator eventIndex = eventMap.find(key);
-        if (eventIndex == eventMap.end())
+        std::optional<std::string> replayValue;
         {
-            eventMap.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(callbackData));
-            status = Firebolt::Error::None;
+            std::lock_guard lck(eventMap_mtx);
+            EventEntry& entry = eventMap[key];
+            first = entry.subscribers.empty();
+            fetch = false;
+            auto it = std::find_if(entry.subscribers.begin(), entry.subscribers.end(), [usercb](const Subscriber &s) { return s->usercb == usercb; });
+            if (it == entry.subscribers.end())
+            {
+                if (first) {
+                    entry.listen = std::make_shared<ListenState>();
+                }
+                listen = entry.listen;
+                entry.subscribers.push_back(subscriber);
+                status = Firebolt::Error::None;
+                if (options.replay) {
+                    entry.replay = true;
+                    replayValue = entry.lastValue;
+                    fetch = !replayValue.has_value();
+                }
+            }
+        }
+        if (replayValue.has_value()) {
+            replay(key, subscriber, *replayValue);
         }
 
         return status;
     }
 
-    Firebolt::Error Unsubscribe(const std::string& event)
+    // Reports the outcome of the listen request sent by the first subscriber. When it failed,
+    // all the subscribers that came meanwhile are removed along with it.
+    void Listened(AtomId key, const std::shared_ptr<ListenState>& listen, Firebolt::Error status)
     {
-        std::lock_guard lck(eventMap_mtx);
-        return eventMap.erase(getKeyFromEvent(event)) > 0 ? Firebolt::Error::None : Firebolt::Error::General;
+        std::list<Subscriber> removed;
+        if (status != Firebolt::Error::None) {
+            std::lock_guard lck(eventMap_mtx);
+            EventMap::iterator eventIt = eventMap.find(key);
+            // Unless they all unsubscribed already and others came since
+            if (eventIt != eventMap.end() && eventIt->second.listen == listen) {
+                removed.swap(eventIt->second.subscribers);
+                eventMap.erase(eventIt);
+            }
+        }
+        listen->Resolve(status);
+        for (Subscriber& subscriber : removed) {
+            // Not notified of anything yet, nothing was listened to
+            std::lock_guard lck(subscriber->delivery_mtx);
+            subscriber->active = false;
+        }
     }
 
-    void Notify(const std::string &method, const std::string &parameters)
+    // Provides the current value of an event, fetched when a replay was asked for before any
+    // notification came in. It is delivered to the subscriber 'usercb' only, unless a
+    // notification, which is more recent, arrived in the meantime
+    void Seed(const std::string& event, void* usercb, const std::string& value)
     {
-        std::string key = method;
-        std::lock_guard lck(eventMap_mtx);
-        EventMap::iterator eventIt = eventMap.find(method);
-        if (eventIt != eventMap.end()) {
-            CallbackDataEvent& callback = eventIt->second;
-            callback.lambda(callback.usercb, callback.userdata, parameters);
+        Seed(FindKey(event), usercb, value);
+    }
+
+    void Seed(AtomId key, void* usercb, const std::string& value)
+    {
+        Subscriber subscriber;
+        {
+            std::lock_guard lck(eventMap_mtx);
+            EventMap::iterator eventIt = eventMap.find(key);
+            if (eventIt == eventMap.end() || eventIt->second.lastValue.has_value()) {
+                return;
+            }
+            eventIt->second.lastValue = value;
+            for (const Subscriber& s : eventIt->second.subscribers) {
+                if (s->usercb == usercb) {
+                    subscriber = s;
+                }
+            }
+        }
+        if (subscriber) {
+            replay(key, subscriber, value);
         }
     }
 
-    void Request(Transport<WPEFramework::Core::JSON::IElement>* transport, unsigned id, const std::string &method, const std::string &parameters)
+    // Removes the subscriber registered with 'usercb', or all of them when 'usercb' is null;
+    // 'last' tells whether the event has no subscribers left
+    Firebolt::Error Unsubscribe(const std::string& event, void* usercb, bool& last)
     {
-        size_t dotPos = method.find('.');
-        if (dotPos == std::string::npos) {
+        return Unsubscribe(FindKey(event), usercb, last);
+    }
+
+    Firebolt::Error Unsubscribe(AtomId key, void* usercb, bool& last)
+    {
+        std::list<Subscriber> removed;
+        {
+            std::lock_guard lck(eventMap_mtx);
+            EventMap::iterator eventIt = eventMap.find(key);
+            if (eventIt == eventMap.end()) {
+                return Firebolt::Error::General;
+            }
+            std::list<Subscriber>& subscribers = eventIt->second.subscribers;
+            for (auto it = subscribers.begin(); it != subscribers.end();) {
+                if (usercb == nullptr || (*it)->usercb == usercb) {
+                    removed.push_back(*it);
+                    it = subscribers.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            last = subscribers.empty();
+            if (last) {
+                eventMap.erase(eventIt);
+            }
+        }
+        for (Subscriber& subscriber : removed) {
+            if (subscriber->deliveringThread.load() == std::this_thread::get_id()) {
+                // Unsubscribing from within its own callback
+                subscriber->active = false;
+                continue;
+            }
+            std::lock_guard lck(subscriber->delivery_mtx);
+            subscriber->active = false;
+        }
+        return removed.empty() ? Firebolt::Error::General : Firebolt::Error::None;
+    }
+
+    bool Subscribed(AtomId key) const
+    {
+        if (key == InvalidAtom) {
+            return false;
+        }
+        std::lock_guard lck(eventMap_mtx);
+        return eventMap.find(key) != eventMap.end();
+    }
+
+    // Conflating subscribers skip a 'superseded' notification, a newer one is on its way
+    void Notify(const std::string &method, const std::string &parameters, bool superseded = false)
+    {
+        AtomId key = Atoms::Instance().Find(method);
+        if (key == InvalidAtom) {
+            // Nobody ever subscribed to it
             return;
         }
-        std::string interface = method.substr(0, dotPos);;
-        std::string methodName = method.substr(dotPos + 1);
-        std::lock_guard lck(providers_mtx);
-        auto provider = providers.find(interface);
-        if (provider == providers.end()) {
+        Notify(key, parameters, superseded);
+    }
+
+    void Notify(AtomId key, const std::string &parameters, bool superseded = false)
+    {
+        std::vector<Subscriber> subscribers;
+        {
+            std::lock_guard lck(eventMap_mtx);
+            EventMap::iterator eventIt = eventMap.find(key);
+            if (eventIt == eventMap.end()) {
+                return;
+            }
+            subscribers.assign(eventIt->second.subscribers.begin(), eventIt->second.subscribers.end());
+            if (eventIt->second.replay) {
+                eventIt->second.lastValue = parameters;
+            }
+        }
+
+        ParsedPayloads parsed;
+        for (Subscriber& subscriber : subscribers) {
+            if (superseded && subscriber->options.conflate && subscriber->options.debounce.count() == 0) {
+                continue;
+            }
+            if (!admit(*subscriber)) {
+                continue;
+            }
+            if (subscriber->options.debounce.count() > 0) {
+                debounce(subscriber, parameters);
+            } else if (subscriber->options.conflate) {
+                conflate(*subscriber, parameters, parsed);
+            } else {
+                deliver(*subscriber, parsedFor(*subscriber, parameters, parsed));
+            }
+        }
+    }
+
+    // 'key' is the id of the method, InvalidAtom when no provider ever registered it
+    void Request(Transport<WPEFramework::Core::JSON::IElement>* transport, unsigned id, AtomId key, const std::string &parameters)
+    {
+        if (key == InvalidAtom) {
             return;
         }
-        auto& methods = provider->second.methods;
-        auto it = methods.begin();
-        while (it != methods.end()) {
-            it = std::find_if(it, methods.end(), [&methodName](const Method &m) { return m.name == methodName; });
-            if (it != methods.end()) {
-                std::string response = it->lambda("{ \"parameters\":" + parameters + "}", it->usercb);
-                transport->SendResponse(id, response);
-                break;
+        std::shared_ptr<const Method> provider;
+        {
+            std::lock_guard lck(providers_mtx);
+            auto it = providers.find(key);
+            if (it == providers.end() || it->second.empty()) {
+                return;
             }
+            provider = it->second.front();
+        }
+        // Providers run on their own executor, so a slow one neither blocks the inbound
+        // path nor (un)registration; asynchronous ones may reply later through the responder
+        ProviderResponder responder(transport, id);
+        auto task = [provider, responder, parameters]() {
+            provider->lambda(parameters, provider->usercb, responder);
+        };
+        if (completionQueue != nullptr) {
+            completionQueue->Post(std::move(task));
+        } else {
+            providerExecutor.Post(std::move(task));
         }
     }
 
     template <typename RESPONSE, typename PARAMETERS, typename CALLBACK>
     Firebolt::Error RegisterProviderInterface(const std::string &fullMethod, const PARAMETERS &parameters, const CALLBACK &callback, void* usercb)
     {
-        uint32_t waitTime = config.DefaultWaitTime;
-
         size_t dotPos = fullMethod.find('.');
         std::string interface = fullMethod.substr(0, dotPos);
         std::string method = fullMethod.substr(dotPos + 1);
@@ -175,48 +664,52 @@ public:
             method.erase(0, 2); // erase "on"
         }
 
-        std::function<std::string(void* usercb, void* params)> actualCallback = callback;
-        DispatchFunctionProvider lambda = [actualCallback, method, waitTime](const std::string &params, void* usercb) {
-            WPEFramework::Core::ProxyType<RESPONSE>* jsonParams = new WPEFramework::Core::ProxyType<RESPONSE>();
-            *jsonParams = WPEFramework::Core::ProxyType<RESPONSE>::Create();
-            (*jsonParams)->FromString(params);
-            return actualCallback(usercb, jsonParams);
-        };
-        std::lock_guard lck(providers_mtx);
-        if (providers.find(interface) == providers.end()) {
-            Interface i = {
-                .name = interface,
+        // Parsed parameters are recycled from a pool owned by the provider
+        auto pool = std::make_shared<WPEFramework::Core::ProxyPoolType<RESPONSE>>(1);
+        DispatchFunctionProvider lambda;
+        if constexpr (std::is_invocable_v<const CALLBACK&, void*, void*, const ProviderResponder&>) {
+            // Asynchronous provider, it replies through the responder whenever it is ready
+            std::function<void(void* usercb, void* params, const ProviderResponder& responder)> actualCallback = callback;
+            lambda = [actualCallback, pool](const std::string &params, void* usercb, const ProviderResponder& responder) {
+                WPEFramework::Core::ProxyType<RESPONSE> jsonParams = pool->Element();
+                parseRequest(*jsonParams, params);
+                actualCallback(usercb, static_cast<void*>(&jsonParams), responder);
             };
-            i.methods.push_back({
-                .name = method,
-                .lambda = lambda,
-                .usercb = usercb,
-            });
-            providers[interface] = i;
         } else {
-            auto &i = providers[interface];
-            auto it = std::find_if(i.methods.begin(), i.methods.end(), [&method, usercb](const Method &m) { return m.name == method && m.usercb == usercb; });
-            if (it == i.methods.end()) {
-                i.methods.push_back({
-                    .name = method,
-                    .lambda = lambda,
-                    .usercb = usercb,
-                });
-            }
+            std::function<std::string(void* usercb, void* params)> actualCallback = callback;
+            lambda = [actualCallback, pool](const std::string &params, void* usercb, const ProviderResponder& responder) {
+                WPEFramework::Core::ProxyType<RESPONSE> jsonParams = pool->Element();
+                parseRequest(*jsonParams, params);
+                responder.Reply(actualCallback(usercb, static_cast<void*>(&jsonParams)));
+            };
+        }
+
+        AtomId key = Atoms::Instance().Intern(interface + '.' + method);
+
+        std::lock_guard lck(providers_mtx);
+        auto &methods = providers[key];
+        auto it = std::find_if(methods.begin(), methods.end(), [usercb](const std::shared_ptr<const Method> &m) { return m->usercb == usercb; });
+        if (it == methods.end()) {
+            methods.push_back(std::make_shared<const Method>(Method{ method, lambda, usercb }));
         }
         return Firebolt::Error::None;
     }
 
     Firebolt::Error UnregisterProviderInterface(const std::string &interface, const std::string &method, void* usercb)
     {
+        AtomId key = Atoms::Instance().Find(interface + '.' + method);
+
         std::lock_guard lck(providers_mtx);
-        try {
-            Interface &i = providers.at(interface);
-            auto it = std::find_if(i.methods.begin(), i.methods.end(), [&method, usercb](const Method &m) { return m.name == method && m.usercb == usercb; });
-            if (it != i.methods.end()) {
-                i.methods.erase(it);
+        auto provider = providers.find(key);
+        if (provider != providers.end()) {
+            auto &methods = provider->second;
+            auto it = std::find_if(methods.begin(), methods.end(), [usercb](const std::shared_ptr<const Method> &m) { return m->usercb == usercb; });
+            if (it != methods.end()) {
+                methods.erase(it);
+            }
+            if (methods.empty()) {
+                providers.erase(provider);
             }
-        } catch (const std::out_of_range &e) {
         }
         return Firebolt::Error::None;
     }
@@ -24,10 +24,12 @@
 #include "FireboltSDK.h"
 #include "common/types.h"
 #include "error.h"
-#include <any>
+#include "gateway/descriptor.h"
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <string_view>
 #include <type_traits>
 
 namespace Firebolt::Helpers
@@ -85,6 +87,56 @@ template <typename T> struct IsVector<std::vector<T>>
     static const bool value = true;
 };
 
+// Walks the elements of a JSON array, without parsing them
+class FIREBOLTSDK_EXPORT ArrayElements
+{
+public:
+    explicit ArrayElements(const std::string& text);
+
+    // Of the elements not walked yet
+    size_t count() const;
+    bool next(std::string_view& element);
+
+private:
+    const std::string& text_;
+    size_t position_;
+};
+
+// Response or event payload parsed straight into a vector: its elements are counted to reserve
+// it, then parsed one at a time
+template <typename JsonType, typename PropertyType> class VectorResult
+{
+public:
+    VectorResult() = default;
+    ~VectorResult() = default;
+
+    bool FromString(const std::string& text)
+    {
+        ArrayElements elements(text);
+        values_.clear();
+        values_.reserve(elements.count());
+
+        JsonType element;
+        std::string_view view;
+        while (elements.next(view) == true)
+        {
+            buffer_.assign(view.data(), view.size());
+            element.Clear();
+            element.FromString(buffer_);
+            values_.push_back(element.Value());
+        }
+        return true;
+    }
+
+    std::vector<PropertyType>& values() { return values_; }
+    const std::vector<PropertyType>& values() const { return values_; }
+
+private:
+    std::vector<PropertyType> values_;
+    // Reused across the elements
+    std::string buffer_;
+};
+
 template <typename JsonType, typename PropertyType>
 FIREBOLTSDK_EXPORT std::enable_if_t<!IsVector<PropertyType>::value, Result<PropertyType>>
 get(const string& methodName)
@@ -116,17 +168,11 @@ template <typename JsonType, typename PropertyType>
 FIREBOLTSDK_EXPORT inline std::enable_if_t<IsVector<PropertyType>::value, Result<PropertyType>>
 get(const std::string& methodName)
 {
-    WPEFramework::Core::JSON::ArrayType<JsonType> jsonResult;
+    VectorResult<JsonType, typename PropertyType::value_type> jsonResult;
     Firebolt::Error status = FireboltSDK::Transport::Properties::Get(methodName, jsonResult);
     if (status == Firebolt::Error::None)
     {
-        Result<PropertyType> result{PropertyType{}};
-        auto index(jsonResult.Elements());
-        while (index.Next() == true)
-        {
-            result->push_back(index.Current().Value());
-        }
-        return result;
+        return Result<PropertyType>{std::move(jsonResult.values())};
     }
     return Result<PropertyType>{status};
 }
@@ -153,25 +199,61 @@ template <typename JsonType, typename PropertyType>
 FIREBOLTSDK_EXPORT inline std::enable_if_t<IsVector<PropertyType>::value, Result<PropertyType>>
 invoke(const string& methodName, const Parameters& parameters)
 {
-    WPEFramework::Core::JSON::ArrayType<JsonType> jsonResult;
+    VectorResult<JsonType, typename PropertyType::value_type> jsonResult;
     auto callStatus{FireboltSDK::Transport::Gateway::Instance().Request(methodName, parameters(), jsonResult)};
     if (Error::None == callStatus)
     {
-        Result<PropertyType> result{PropertyType{}};
-        auto index(jsonResult.Elements());
-        while (index.Next() == true)
-        {
-            result->push_back(index.Current().Value());
-        }
-        return result;
+        return Result<PropertyType>{std::move(jsonResult.values())};
     }
     return Result<PropertyType>{callStatus};
 }
 
+// Methods given by a FireboltSDK::Transport::Descriptor, their name string is built once rather
+// than on every call
+template <typename Descriptor>
+FIREBOLTSDK_EXPORT inline Result<typename Descriptor::PropertyType> get()
+{
+    return get<typename Descriptor::JsonType, typename Descriptor::PropertyType>(Descriptor::NameString());
+}
+
+template <typename Descriptor>
+FIREBOLTSDK_EXPORT inline Result<typename Descriptor::PropertyType> get(const Parameters& parameters)
+{
+    return get<typename Descriptor::JsonType, typename Descriptor::PropertyType>(Descriptor::NameString(), parameters);
+}
+
+template <typename Descriptor>
+FIREBOLTSDK_EXPORT inline Result<typename Descriptor::PropertyType> invoke(const Parameters& parameters)
+{
+    return invoke<typename Descriptor::JsonType, typename Descriptor::PropertyType>(Descriptor::NameString(), parameters);
+}
+
+// What a notification of a value of that type is called with
+template <typename PropertyType>
+using Notification = std::function<void(std::conditional_t<IsVector<PropertyType>::value, const PropertyType&, PropertyType>)>;
+
 struct SubscriptionData
 {
+    SubscriptionData() = default;
+    template <typename Function>
+    SubscriptionData(const string& eventName_, Function&& function,
+                     FireboltSDK::Transport::AtomId key_ = FireboltSDK::Transport::InvalidAtom)
+        : eventName(eventName_), key(key_),
+          notification(std::make_shared<std::decay_t<Function>>(std::forward<Function>(function)))
+    {
+    }
+
+    // The type is the one given when subscribing, known to the callback registered with it, so
+    // notifying neither copies the function nor looks its type up
+    template <typename Function> const Function& notifier() const
+    {
+        return *static_cast<const Function*>(notification.get());
+    }
+
     string eventName;
-    std::any notification;
+    // Of the event, when known upfront
+    FireboltSDK::Transport::AtomId key = FireboltSDK::Transport::InvalidAtom;
+    std::shared_ptr<void> notification;
 };
 
 template <typename JsonType, typename PropertyType>
@@ -184,12 +266,11 @@ void onPropertyChangedCallback(void* subscriptionDataPtr, const void* userData,
 
     if (proxyResponse.IsValid() == true)
     {
-        auto changedProperty = proxyResponse->Value();
+        // A copy, the payload is shared by the subscribers, moved into the notification
+        PropertyType changedProperty = proxyResponse->Value();
         proxyResponse.Release();
-        SubscriptionData* subscriptionData = reinterpret_cast<SubscriptionData*>(subscriptionDataPtr);
-        std::function<void(PropertyType)> notifier =
-            std::any_cast<std::function<void(PropertyType)>>(subscriptionData->notification);
-        notifier(changedProperty);
+        const SubscriptionData* subscriptionData = reinterpret_cast<const SubscriptionData*>(subscriptionDataPtr);
+        subscriptionData->notifier<std::function<void(PropertyType)>>()(std::move(changedProperty));
     }
 }
 
@@ -197,32 +278,113 @@ void onPropertyChangedCallback(void* subscriptionDataPtr, const void* userData,
 template <typename JsonType, typename PropertyType>
 inline void onContainerPropertyChangedCallback(void* subscriptionDataPtr, const void* userData, void* jsonResponse)
 {
-    WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::ArrayType<JsonType>>& proxyResponse =
-        *(reinterpret_cast<WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::ArrayType<JsonType>>*>(jsonResponse));
+    WPEFramework::Core::ProxyType<VectorResult<JsonType, PropertyType>>& proxyResponse =
+        *(reinterpret_cast<WPEFramework::Core::ProxyType<VectorResult<JsonType, PropertyType>>*>(jsonResponse));
 
     ASSERT(proxyResponse.IsValid() == true);
 
     if (proxyResponse.IsValid() == true)
     {
-        std::vector<PropertyType> values;
+        const SubscriptionData* subscriptionData = reinterpret_cast<const SubscriptionData*>(subscriptionDataPtr);
+        // The payload is shared by the subscribers, it is handed over as it is
+        subscriptionData->notifier<std::function<void(const std::vector<PropertyType>&)>>()(proxyResponse->values());
+        proxyResponse.Release();
+    }
+}
+
+// Subscriptions made together by SubscriptionHelper::subscribe(SubscriptionBatch&&), their
+// listen requests are all sent before any response is waited for
+class FIREBOLTSDK_EXPORT SubscriptionBatch
+{
+public:
+    template <typename JsonType, typename PropertyType>
+    SubscriptionBatch& add(const string& eventName, std::function<void(PropertyType)>&& notification,
+                           const FireboltSDK::Transport::SubscriptionOptions& options = {})
+    {
+        return append<JsonType>(FireboltSDK::Transport::InvalidAtom, eventName, std::move(notification),
+                                onPropertyChangedCallback<JsonType, PropertyType>, options);
+    }
 
-        auto index(proxyResponse->Elements());
-        while (index.Next() == true)
+    // Specialised version for containers
+    template <typename JsonType, typename PropertyType>
+    SubscriptionBatch& add(const string& eventName, std::function<void(const std::vector<PropertyType>&)>&& notification,
+                           const FireboltSDK::Transport::SubscriptionOptions& options = {})
+    {
+        return append<VectorResult<JsonType, PropertyType>>(FireboltSDK::Transport::InvalidAtom, eventName,
+                                                            std::move(notification),
+                                                            onContainerPropertyChangedCallback<JsonType, PropertyType>,
+                                                            options);
+    }
+
+    // The event and its key are those of the Descriptor
+    template <typename Descriptor>
+    SubscriptionBatch& add(Notification<typename Descriptor::PropertyType>&& notification,
+                           const FireboltSDK::Transport::SubscriptionOptions& options = {})
+    {
+        using JsonType = typename Descriptor::JsonType;
+        using PropertyType = typename Descriptor::PropertyType;
+        if constexpr (IsVector<PropertyType>::value)
         {
-            values.push_back(index.Current().Value());
+            using ElementType = typename PropertyType::value_type;
+            return append<VectorResult<JsonType, ElementType>>(Descriptor::Key(), Descriptor::EventNameString(),
+                                                               std::move(notification),
+                                                               onContainerPropertyChangedCallback<JsonType, ElementType>,
+                                                               options);
         }
-        proxyResponse.Release();
+        else
+        {
+            return append<JsonType>(Descriptor::Key(), Descriptor::EventNameString(), std::move(notification),
+                                    onPropertyChangedCallback<JsonType, PropertyType>, options);
+        }
+    }
+
+    size_t size() const { return entries_.size(); }
+
+private:
+    friend class SubscriptionHelper;
+
+    struct Entry
+    {
+        std::shared_ptr<SubscriptionData> data;
+        // Registers the subscriber and sends its listen request
+        std::function<FireboltSDK::Transport::PendingSubscription(const std::shared_ptr<SubscriptionData>&)> begin;
+    };
 
-        SubscriptionData* subscriptionData = reinterpret_cast<SubscriptionData*>(subscriptionDataPtr);
-        std::function<void(const std::vector<PropertyType>&)> notifier =
-            std::any_cast<std::function<void(const std::vector<PropertyType>&)>>(subscriptionData->notification);
-        notifier(values);
+    // Without a 'key' it is worked out from the event name
+    template <typename RESULT, typename Function>
+    SubscriptionBatch& append(FireboltSDK::Transport::AtomId key, const string& eventName, Function&& notification,
+                              void (*callback)(void*, const void*, void*),
+                              const FireboltSDK::Transport::SubscriptionOptions& options)
+    {
+        entries_.push_back(Entry{std::make_shared<SubscriptionData>(eventName, std::forward<Function>(notification), key),
+                                 [key, eventName, callback, options](const std::shared_ptr<SubscriptionData>& data)
+                                 {
+                                     // The gateway holds on to the notifier while it runs, so the data it
+                                     // refers to outlives an unsubscribe made meanwhile, even from the
+                                     // notification itself
+                                     auto notifier = [data, callback](void*, const void* userData, void* response)
+                                     { callback(data.get(), userData, response); };
+                                     JsonObject jsonParameters;
+                                     if (key != FireboltSDK::Transport::InvalidAtom)
+                                     {
+                                         return FireboltSDK::Transport::Event::Instance().BeginSubscribe<RESULT>(
+                                             key, eventName, jsonParameters, notifier, reinterpret_cast<void*>(data.get()),
+                                             nullptr, options);
+                                     }
+                                     return FireboltSDK::Transport::Event::Instance().BeginSubscribe<RESULT>(
+                                         eventName, jsonParameters, notifier, reinterpret_cast<void*>(data.get()), nullptr,
+                                         options);
+                                 }});
+        return *this;
     }
-}
+
+    std::vector<Entry> entries_;
+};
 
 class FIREBOLTSDK_EXPORT SubscriptionHelper
 {
 public:
+    // The listen requests to cancel are all sent before any response is waited for
     void unsubscribeAll();
 
 protected:
@@ -231,48 +393,42 @@ protected:
 
     Result<void> unsubscribe(SubscriptionId id);
     template <typename JsonType, typename PropertyType>
-    Result<SubscriptionId> subscribe(const string& eventName, std::function<void(PropertyType)>&& notification)
+    Result<SubscriptionId> subscribe(const string& eventName, std::function<void(PropertyType)>&& notification,
+                                     const FireboltSDK::Transport::SubscriptionOptions& options = {})
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        subscriptions_[currentId_] = SubscriptionData{eventName, std::move(notification)};
-        JsonObject jsonParameters;
-        void* notificationPtr = reinterpret_cast<void*>(&subscriptions_[currentId_]);
-        Error status =
-            FireboltSDK::Transport::Event::Instance().Subscribe<JsonType>(eventName, jsonParameters,
-                                                               onPropertyChangedCallback<JsonType, PropertyType>,
-                                                               notificationPtr, nullptr);
-        if (Error::None == status)
-        {
-            return Result<SubscriptionId>{currentId_++};
-        }
-        subscriptions_.erase(currentId_);
-        return Result<SubscriptionId>{status};
+        SubscriptionBatch batch;
+        batch.add<JsonType, PropertyType>(eventName, std::move(notification), options);
+        return std::move(subscribe(std::move(batch)).front());
     }
 
     // Specialised version for containers
     template <typename JsonType, typename PropertyType>
     Result<SubscriptionId> subscribe(const string& eventName,
-                                     std::function<void(const std::vector<PropertyType>&)>&& notification)
+                                     std::function<void(const std::vector<PropertyType>&)>&& notification,
+                                     const FireboltSDK::Transport::SubscriptionOptions& options = {})
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        subscriptions_[currentId_] = SubscriptionData{eventName, std::move(notification)};
-        JsonObject jsonParameters;
-        void* notificationPtr = reinterpret_cast<void*>(&subscriptions_[currentId_]);
-        Error status =
-            FireboltSDK::Transport::Event::Instance().Subscribe<JsonType>(eventName, jsonParameters,
-                                                               onContainerPropertyChangedCallback<JsonType, PropertyType>,
-                                                               notificationPtr, nullptr);
-        if (Error::None == status)
-        {
-            return Result<SubscriptionId>{currentId_++};
-        }
-        subscriptions_.erase(currentId_);
-        return Result<SubscriptionId>{status};
+        SubscriptionBatch batch;
+        batch.add<JsonType, PropertyType>(eventName, std::move(notification), options);
+        return std::move(subscribe(std::move(batch)).front());
     }
 
+    template <typename Descriptor>
+    Result<SubscriptionId> subscribe(Notification<typename Descriptor::PropertyType>&& notification,
+                                     const FireboltSDK::Transport::SubscriptionOptions& options = {})
+    {
+        SubscriptionBatch batch;
+        batch.add<Descriptor>(std::move(notification), options);
+        return std::move(subscribe(std::move(batch)).front());
+    }
+
+    // One result per subscription of the batch, in the same order. The lock is not held
+    // while waiting for the endpoint, notifications of the other subscriptions keep flowing.
+    std::vector<Result<SubscriptionId>> subscribe(SubscriptionBatch&& batch);
+
 private:
     std::mutex mutex_;
-    std::map<uint64_t, SubscriptionData> subscriptions_;
+    // Shared with the notifiers registered in the gateway
+    std::map<uint64_t, std::shared_ptr<SubscriptionData>> subscriptions_;
     uint64_t currentId_{0};
 };
 } // namespace Firebolt::Transport
@@ -31,6 +31,8 @@
 #include <nlohmann/json.hpp>
 #include <nlohmann/json-schema.hpp>
 
+#include "Logger.h"
+
 #ifndef UNIT_TEST
 #error "must be included only for UTs"
 #endif
@@ -170,7 +172,7 @@ class JsonEngine
                     // Schema validation
                     const json requestParams = json::parse(message->Parameters.Value());
                     if(method["params"].empty()) {
-                        std::cout << "Schema validation for empty parameters" << std::endl;
+                        FIREBOLT_LOG_DEBUG(FireboltSDK::Transport::Logger::Category::OpenRPC, "JsonEngine", "Schema validation for empty parameters of %s", methodName.c_str());
                         EXPECT_EQ(requestParams, "{}"_json);
                     }
                     else {
@@ -185,7 +187,7 @@ class JsonEngine
                                 try{
                                     validator.set_root_schema(dereferenced_schema["schema"]);
                                     validator.validate(requestParams[paramName]);
-                                    std::cout << "Schema validation succeeded" << std::endl;
+                                    FIREBOLT_LOG_DEBUG(FireboltSDK::Transport::Logger::Category::OpenRPC, "JsonEngine", "Schema validation of %s succeeded", paramName.c_str());
                                 }
                                 catch (const std::exception &e){
                                     FAIL() << "Schema validation error: " << e.what() << std::endl;
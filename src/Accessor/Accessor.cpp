@@ -27,6 +27,7 @@ namespace FireboltSDK::Transport {
     Accessor::Accessor(const string& configLine)
         : _workerPool()
         , _transport(nullptr)
+        , _completionQueue(nullptr)
         , _config()
     {
         ASSERT(_singleton == nullptr);
@@ -34,11 +35,47 @@ namespace FireboltSDK::Transport {
         _config.FromString(configLine);
 
         Logger::SetLogLevel(WPEFramework::Core::EnumerateType<Logger::LogLevel>(_config.LogLevel.Value().c_str()).Value());
+        auto categoryLogLevel = _config.CategoryLogLevels.Elements();
+        while (categoryLogLevel.Next() == true) {
+            const string category = _T("FireboltSDK::") + categoryLogLevel.Current().Category.Value();
+            WPEFramework::Core::EnumerateType<Logger::Category> categoryType(category.c_str());
+            WPEFramework::Core::EnumerateType<Logger::LogLevel> levelType(categoryLogLevel.Current().Level.Value().c_str());
+            if ((categoryType.IsSet() == true) && (levelType.IsSet() == true)) {
+                Logger::SetLogLevel(categoryType.Value(), levelType.Value());
+            }
+        }
+        Logger::SetRateLimit(_config.LogBurst.Value(), _config.LogRate.Value());
+        Logger::Mode logMode = Logger::Mode::Sync;
+        if (_config.LogMode.Value() == _T("async")) {
+            logMode = Logger::Mode::Async;
+        } else if (_config.LogMode.Value() == _T("binary")) {
+            if (Logger::SetBinaryLog(_config.LogFile.Value(), _config.LogFileSize.Value()) == Firebolt::Error::None) {
+                logMode = Logger::Mode::Binary;
+            } else {
+                FIREBOLT_LOG_ERROR(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Cannot open binary log %s", _config.LogFile.Value().c_str());
+            }
+        }
+        Logger::SetMode(logMode);
 
         FIREBOLT_LOG_INFO(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Url = %s", _config.WsUrl.Value().c_str());
-        _workerPool = WPEFramework::Core::ProxyType<WorkerPoolImplementation>::Create(_config.WorkerPool.ThreadCount.Value(), _config.WorkerPool.StackSize.Value(), _config.WorkerPool.QueueSize.Value());
+        WorkerPoolImplementation::Scheduler scheduler = (_config.WorkerPool.Scheduler.Value() == _T("workStealing"))
+            ? WorkerPoolImplementation::Scheduler::WorkStealing : WorkerPoolImplementation::Scheduler::Shared;
+        WorkStealingPool::Elasticity elasticity;
+        elasticity.MaxThreads = _config.WorkerPool.MaxThreadCount.Value();
+        elasticity.SpawnThreshold = _config.WorkerPool.SpawnThreshold.Value();
+        elasticity.IdleTimeout = _config.WorkerPool.IdleTimeout.Value();
+        ThreadSettings settings;
+        settings.Affinity = _config.WorkerPool.Affinity.Value();
+        settings.Scheduling = (_config.WorkerPool.Policy.Value() == _T("fifo")) ? ThreadSettings::Policy::Fifo : ThreadSettings::Policy::Other;
+        settings.Priority = _config.WorkerPool.Priority.Value();
+        settings.Name = _config.WorkerPool.ThreadName.Value();
+        _workerPool = WPEFramework::Core::ProxyType<WorkerPoolImplementation>::Create(_config.WorkerPool.ThreadCount.Value(), _config.WorkerPool.StackSize.Value(), _config.WorkerPool.QueueSize.Value(), scheduler, elasticity, settings);
         WPEFramework::Core::WorkerPool::Assign(&(*_workerPool));
         _workerPool->Run();
+
+        if (_config.EnableCompletionQueue.Value() == true) {
+            _completionQueue = new CompletionQueue();
+        }
     }
 
     Accessor::~Accessor()
@@ -46,6 +83,14 @@ namespace FireboltSDK::Transport {
         WPEFramework::Core::IWorkerPool::Assign(nullptr);
         _workerPool->Stop();
 
+        if (_completionQueue != nullptr) {
+            delete _completionQueue;
+            _completionQueue = nullptr;
+        }
+
+        // Writes out the logs still queued
+        Logger::SetMode(Logger::Mode::Sync);
+
         ASSERT(_singleton != nullptr);
         _singleton = nullptr;
     }
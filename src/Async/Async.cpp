@@ -22,8 +22,9 @@
 namespace FireboltSDK::Transport {
     Async* Async::_singleton = nullptr;
     Async::Async()
-        : _methodMap()
-        , _adminLock()
+        : _shards()
+        , _nextHandle(InvalidHandle + 1)
+        , _completionQueue(nullptr)
     {
         ASSERT(_singleton == nullptr);
         _singleton = this;
@@ -56,19 +57,27 @@ namespace FireboltSDK::Transport {
 
     void Async::Clear()
     {
-        _adminLock.Lock();
-        MethodMap::iterator index = _methodMap.begin();
-        while (index != _methodMap.end()) {
-            CallbackMap::iterator callbackIndex = index->second.begin();
-            while (callbackIndex != index->second.end()) {
-                if (IsValidJob(callbackIndex->second)) {
-                    WPEFramework::Core::IWorkerPool::Instance().Revoke(callbackIndex->second.job);
+        std::vector<MessageID> outstanding;
+        std::vector<WPEFramework::Core::ProxyType<Job>> jobs;
+        for (Shard& shard : _shards) {
+            shard.lock.Lock();
+            for (auto& call : shard.calls) {
+                if (IsValidJob(call.second)) {
+                    jobs.push_back(call.second.job);
+                } else if (call.second.id != 0) {
+                    outstanding.push_back(call.second.id);
                 }
-                callbackIndex = index->second.erase(callbackIndex);
             }
-            index = _methodMap.erase(index);
+            shard.calls.clear();
+            shard.lock.Unlock();
+        }
+
+        // Outside of the locks, a job being revoked is waited for and cancelling completes the requests
+        for (auto& job : jobs) {
+            TrackedJob::Revoke(job);
+        }
+        for (MessageID id : outstanding) {
+            Gateway::Instance().Cancel(id);
         }
-        _adminLock.Unlock();
     }
 }
-
@@ -0,0 +1,116 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CompletionQueue.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace FireboltSDK::Transport {
+
+    CompletionQueue::CompletionQueue()
+        : _head(&_stub)
+        , _tail(&_stub)
+        , _stub()
+        , _descriptor(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+    }
+
+    CompletionQueue::~CompletionQueue()
+    {
+        // Tasks left over are dropped without being run
+        Node* node;
+        while ((node = Pop()) != nullptr) {
+            delete node;
+        }
+        if (_descriptor != -1) {
+            ::close(_descriptor);
+        }
+    }
+
+    void CompletionQueue::Post(Task&& task)
+    {
+        Node* node = new Node();
+        node->task = std::move(task);
+        Push(node);
+
+        // Signalled once the node is linked, so a Drain() woken by it is bound to find it
+        if (_descriptor != -1) {
+            uint64_t one = 1;
+            ssize_t written = ::write(_descriptor, &one, sizeof(one));
+            (void)written;
+        }
+    }
+
+    uint32_t CompletionQueue::Drain()
+    {
+        // Reset the descriptor first, anything posted from now on signals it again
+        if (_descriptor != -1) {
+            uint64_t count;
+            ssize_t read = ::read(_descriptor, &count, sizeof(count));
+            (void)read;
+        }
+
+        uint32_t ran = 0;
+        Node* node;
+        while ((node = Pop()) != nullptr) {
+            node->task();
+            delete node;
+            ++ran;
+        }
+        return ran;
+    }
+
+    void CompletionQueue::Push(Node* node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = _head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    CompletionQueue::Node* CompletionQueue::Pop()
+    {
+        Node* tail = _tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &_stub) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            _tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            _tail = next;
+            return tail;
+        }
+        if (tail != _head.load(std::memory_order_acquire)) {
+            // A producer is half way through linking its node, it signals once done
+            return nullptr;
+        }
+        // The last node can only be taken with the stub queued behind it
+        Push(&_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            _tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+}
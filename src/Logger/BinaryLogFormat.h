@@ -0,0 +1,74 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// On-disk layout of the binary log, shared by the Logger and the decoder in tools/
+
+namespace FireboltSDK::Transport::BinaryLog {
+
+    static constexpr char Magic[8] = { 'F', 'B', 'L', 'O', 'G', '0', '0', '1' };
+    static constexpr uint32_t RecordMagic = 0xFB10CA7E;
+    // Record sizes and offsets, so that a header is never split by the end of the ring
+    static constexpr uint32_t Alignment = 8;
+
+    // Start of the file, followed by 'capacity' bytes of records
+    struct FileHeader {
+        char magic[8];
+        uint64_t capacity;
+        // Bytes reserved since the start, the ring holds the last 'capacity' of them
+        uint64_t head;
+        uint32_t process;
+        uint32_t reserved;
+    };
+
+    // A record with a length smaller than a RecordHeader, or with site 0, is padding
+    struct RecordHeader {
+        uint32_t magic;
+        // Of the whole record, aligned
+        uint32_t length;
+        // Line of the sites file describing the log statement
+        uint32_t site;
+        // Of the arguments following the header
+        uint32_t size;
+        uint64_t time;
+        uint64_t thread;
+    };
+
+    // Each argument is a tag followed by its value
+    enum class Tag : uint8_t {
+        // int64_t
+        Signed = 'i',
+        // uint64_t
+        Unsigned = 'u',
+        // double
+        Double = 'd',
+        // uint16_t length and the characters, without terminator
+        String = 's',
+        // uint64_t
+        Pointer = 'p'
+    };
+
+    static constexpr uint32_t Align(const uint32_t size)
+    {
+        return ((size + Alignment - 1) & ~(Alignment - 1));
+    }
+}
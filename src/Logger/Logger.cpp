@@ -19,9 +19,23 @@
 #include "Module.h"
 #include "error.h"
 #include "Logger.h"
+#include "BinaryLogFormat.h"
+#include <fcntl.h>
 #include <stdio.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #ifdef ENABLE_SYSLOG
 #define LOG_MESSAGE(message) \
     do { syslog(sLOG_NOTIC, "%s", message); } while (0)
@@ -48,64 +62,568 @@ ENUM_CONVERSION_BEGIN(FireboltSDK::Transport::Logger::Category)
     { FireboltSDK::Transport::Logger::Category::Manage, _TXT("FireboltSDK::Manage") },
     { FireboltSDK::Transport::Logger::Category::Discovery, _TXT("FireboltSDK::Discovery") },
     { FireboltSDK::Transport::Logger::Category::PlayerProvider, _TXT("FireboltSDK::PlayerProvider") },
-    { FireboltSDK::Transport::Logger::Category::PlayerProvider, _TXT("FireboltSDK::PlayerManager") },
+    { FireboltSDK::Transport::Logger::Category::PlayerManager, _TXT("FireboltSDK::PlayerManager") },
 
 ENUM_CONVERSION_END(FireboltSDK::Transport::Logger::Category)
 
 }
 
 namespace FireboltSDK::Transport {
-    /* static */  Logger::LogLevel Logger::_logLevel = Logger::LogLevel::Error;
+    // Zero initialised, LogLevel::Error
+    /* static */  std::atomic<Logger::LogLevel> Logger::_logLevels[static_cast<uint8_t>(Logger::Category::MaxCategory)];
+    /* static */  std::atomic<Logger::Mode> Logger::_mode(Logger::Mode::Sync);
+    /* static */  std::atomic<uint32_t> Logger::_burst(50);
+    /* static */  std::atomic<uint64_t> Logger::_interval(1000000 / 10);
+
+    // Everything needed to format a message later on, on another thread. The log statement
+    // is static so only its address is kept, the module name may be a temporary and is copied.
+    struct Logger::Record {
+        static constexpr uint8_t NameSize = 64;
+
+        uint64_t time;
+        const Site* site;
+        long thread;
+        char module[NameSize];
+        char message[MaxBufSize];
+
+        void Fill(const Site& logSite, const std::string& moduleName)
+        {
+            time = WPEFramework::Core::Time::Now().Ticks();
+            site = &logSite;
+            thread = TRACE_THREAD_ID;
+            const size_t length = std::min(moduleName.size(), static_cast<size_t>(NameSize - 1));
+            memcpy(module, moduleName.data(), length);
+            module[length] = '\0';
+        }
+    };
+
+    // Single producer, the owning thread, and single consumer, the backend thread
+    class Logger::Ring {
+    public:
+        static constexpr uint32_t Capacity = 64;
+
+        Ring(const Ring&) = delete;
+        Ring& operator=(const Ring&) = delete;
+        Ring() = default;
+
+        Record* Reserve()
+        {
+            uint32_t head = _head.load(std::memory_order_relaxed);
+            if ((head - _tail.load(std::memory_order_acquire)) == Capacity) {
+                return nullptr;
+            }
+            return &_records[head % Capacity];
+        }
+
+        void Commit()
+        {
+            _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        const Record* Front() const
+        {
+            uint32_t tail = _tail.load(std::memory_order_relaxed);
+            return (tail != _head.load(std::memory_order_acquire)) ? &_records[tail % Capacity] : nullptr;
+        }
+
+        void Pop()
+        {
+            _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // Set once the owning thread has exited
+        std::atomic<bool> orphan { false };
+
+    private:
+        std::array<Record, Capacity> _records;
+        std::atomic<uint32_t> _head { 0 };
+        std::atomic<uint32_t> _tail { 0 };
+    };
+
+    // Owns the rings and the thread writing them out, in time order
+    class Logger::Backend {
+    private:
+        struct Holder {
+            std::shared_ptr<Ring> ring;
+            ~Holder()
+            {
+                if (ring != nullptr) {
+                    ring->orphan = true;
+                }
+            }
+        };
+
+        static constexpr uint32_t IdleTime = 50; // ms
+
+    public:
+        Backend(const Backend&) = delete;
+        Backend& operator=(const Backend&) = delete;
+        Backend() = default;
+
+        ~Backend()
+        {
+            Stop();
+        }
+
+        static Backend& Instance()
+        {
+            static Backend backend;
+            return backend;
+        }
+
+        void Start()
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            if (_running == false) {
+                _running = true;
+                _thread = std::thread(&Backend::Run, this);
+            }
+        }
+
+        void Stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                _running = false;
+            }
+            _wake.notify_one();
+            if (_thread.joinable() == true) {
+                _thread.join();
+            }
+        }
+
+        bool Push(const Site& site, const std::string& module, const char* format, va_list arguments)
+        {
+            Ring& ring = ThreadRing();
+            Record* record = ring.Reserve();
+            if (record == nullptr) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            record->Fill(site, module);
+            vsnprintf(record->message, sizeof(record->message), format, arguments);
+            ring.Commit();
+
+            // A lost wake-up only delays the write by IdleTime
+            if (_signalled.exchange(true, std::memory_order_acq_rel) == false) {
+                _wake.notify_one();
+            }
+            return true;
+        }
+
+        uint64_t Dropped() const
+        {
+            return _dropped.load(std::memory_order_relaxed);
+        }
+
+    private:
+        Ring& ThreadRing()
+        {
+            static thread_local Holder holder;
+            if (holder.ring == nullptr) {
+                holder.ring = std::make_shared<Ring>();
+                std::lock_guard<std::mutex> lock(_lock);
+                _rings.push_back(holder.ring);
+            }
+            return *holder.ring;
+        }
+
+        void Run()
+        {
+            std::vector<std::shared_ptr<Ring>> rings;
+            std::unique_lock<std::mutex> lock(_lock);
+            while (true) {
+                rings = _rings;
+                bool running = _running;
+                _signalled = false;
+                lock.unlock();
+
+                uint32_t written = WriteOut(rings);
+                uint64_t dropped = _dropped.load(std::memory_order_relaxed);
+                if (dropped != _reported) {
+                    static const Site site(LogLevel::Warning, Category::Core, __FILE__, __func__, __LINE__);
+                    Record record;
+                    record.Fill(site, "Logger");
+                    snprintf(record.message, sizeof(record.message), "%" PRIu64 " messages dropped", dropped - _reported);
+                    Write(record);
+                    _reported = dropped;
+                }
+
+                lock.lock();
+                _rings.erase(std::remove_if(_rings.begin(), _rings.end(), [](const std::shared_ptr<Ring>& ring) {
+                    return (ring->orphan == true) && (ring->Front() == nullptr);
+                }), _rings.end());
+                if (running == false) {
+                    // Stopped, what was queued before is written out by now
+                    break;
+                }
+                if (written == 0) {
+                    _wake.wait_for(lock, std::chrono::milliseconds(IdleTime), [this]() {
+                        return (_running == false) || (_signalled.load(std::memory_order_acquire) == true);
+                    });
+                }
+            }
+        }
+
+        // Writes what is queued so far, oldest first across all the threads
+        uint32_t WriteOut(const std::vector<std::shared_ptr<Ring>>& rings)
+        {
+            uint32_t written = 0;
+            while (true) {
+                Ring* oldest = nullptr;
+                const Record* next = nullptr;
+                for (const auto& ring : rings) {
+                    const Record* record = ring->Front();
+                    if ((record != nullptr) && ((next == nullptr) || (record->time < next->time))) {
+                        oldest = ring.get();
+                        next = record;
+                    }
+                }
+                if (oldest == nullptr) {
+                    return written;
+                }
+                Write(*next);
+                oldest->Pop();
+                ++written;
+            }
+        }
+
+    private:
+        std::mutex _lock;
+        std::condition_variable _wake;
+        std::vector<std::shared_ptr<Ring>> _rings;
+        std::thread _thread;
+        bool _running = false;
+        std::atomic<bool> _signalled { false };
+        std::atomic<uint64_t> _dropped { 0 };
+        uint64_t _reported = 0;
+    };
+
+    // The file ring of the Binary mode. Writers take no lock, so once opened it stays mapped
+    // until the process exits.
+    class BinaryFile {
+    private:
+        static constexpr uint32_t MinimumSize = 64 * 1024;
+
+    public:
+        BinaryFile(const BinaryFile&) = delete;
+        BinaryFile& operator=(const BinaryFile&) = delete;
+        BinaryFile() = default;
+        ~BinaryFile() = default;
+
+        static BinaryFile& Instance()
+        {
+            static BinaryFile file;
+            return file;
+        }
+
+        // Only the first file opened is used
+        Firebolt::Error Open(const std::string& path, const uint32_t size)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            if (_header.load(std::memory_order_relaxed) != nullptr) {
+                return Firebolt::Error::None;
+            }
+
+            const uint64_t capacity = BinaryLog::Align(std::max(size, MinimumSize));
+            const size_t length = sizeof(BinaryLog::FileHeader) + capacity;
+            int descriptor = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (descriptor < 0) {
+                return Firebolt::Error::General;
+            }
+            void* mapping = MAP_FAILED;
+            if (ftruncate(descriptor, length) == 0) {
+                mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+            }
+            close(descriptor);
+            if (mapping == MAP_FAILED) {
+                return Firebolt::Error::General;
+            }
+            _sites = fopen((path + ".sites").c_str(), "we");
+            if (_sites == nullptr) {
+                munmap(mapping, length);
+                return Firebolt::Error::General;
+            }
+
+            BinaryLog::FileHeader* header = static_cast<BinaryLog::FileHeader*>(mapping);
+            memcpy(header->magic, BinaryLog::Magic, sizeof(header->magic));
+            header->capacity = capacity;
+            header->head = 0;
+            header->process = TRACE_PROCESS_ID;
+            _records = static_cast<uint8_t*>(mapping) + sizeof(BinaryLog::FileHeader);
+            _capacity = capacity;
+            _header.store(header, std::memory_order_release);
+            return Firebolt::Error::None;
+        }
+
+        bool IsOpen() const
+        {
+            return (_header.load(std::memory_order_acquire) != nullptr);
+        }
+
+        uint32_t Register(Logger::Site& site, const std::string& module, const char* format)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            uint32_t id = site.id.load(std::memory_order_relaxed);
+            if (id == 0) {
+                id = ++_registered;
+                if (_sites != nullptr) {
+                    const char* separator = strrchr(site.file, '/');
+                    fprintf(_sites, "%u\t%s\t%s\t%s\t%s\t%u\t%s\t", id,
+                        WPEFramework::Core::EnumerateType<Logger::LogLevel>(site.level).Data(),
+                        WPEFramework::Core::EnumerateType<Logger::Category>(site.category).Data(),
+                        module.c_str(), (separator != nullptr) ? (separator + 1) : site.file, site.line, site.function);
+                    // One site per line, the format may hold anything
+                    for (const char* c = format; *c != '\0'; ++c) {
+                        switch (*c) {
+                        case '\\': fputs("\\\\", _sites); break;
+                        case '\t': fputs("\\t", _sites); break;
+                        case '\n': fputs("\\n", _sites); break;
+                        default: fputc(*c, _sites); break;
+                        }
+                    }
+                    fputc('\n', _sites);
+                    fflush(_sites);
+                }
+                site.id.store(id, std::memory_order_release);
+            }
+            return id;
+        }
+
+        void Append(const uint32_t site, const Logger::Payload& payload)
+        {
+            BinaryLog::FileHeader* header = _header.load(std::memory_order_acquire);
+            if (header == nullptr) {
+                return;
+            }
+
+            const uint32_t length = BinaryLog::Align(sizeof(BinaryLog::RecordHeader) + payload.Size());
+            while (true) {
+                const uint64_t position = __atomic_fetch_add(&header->head, length, __ATOMIC_RELAXED) % _capacity;
+                if ((position + length) <= _capacity) {
+                    BinaryLog::RecordHeader* record = reinterpret_cast<BinaryLog::RecordHeader*>(_records + position);
+                    // Not to be taken for the record it overwrites while being written
+                    __atomic_store_n(&record->magic, 0, __ATOMIC_RELAXED);
+                    record->length = length;
+                    record->site = site;
+                    record->size = payload.Size();
+                    record->time = WPEFramework::Core::Time::Now().Ticks();
+                    record->thread = static_cast<uint64_t>(TRACE_THREAD_ID);
+                    memcpy(record + 1, payload.Data(), payload.Size());
+                    __atomic_store_n(&record->magic, BinaryLog::RecordMagic, __ATOMIC_RELEASE);
+                    return;
+                }
+                // It would wrap around, both parts are skipped and it is tried again
+                Pad(position, _capacity - position);
+                Pad(0, position + length - _capacity);
+            }
+        }
+
+    private:
+        void Pad(const uint64_t position, const uint64_t length)
+        {
+            if (length > 0) {
+                BinaryLog::RecordHeader* record = reinterpret_cast<BinaryLog::RecordHeader*>(_records + position);
+                record->length = static_cast<uint32_t>(length);
+                if (length >= sizeof(BinaryLog::RecordHeader)) {
+                    record->site = 0;
+                }
+                __atomic_store_n(&record->magic, BinaryLog::RecordMagic, __ATOMIC_RELEASE);
+            }
+        }
+
+    private:
+        std::mutex _lock;
+        std::atomic<BinaryLog::FileHeader*> _header { nullptr };
+        uint8_t* _records = nullptr;
+        uint64_t _capacity = 0;
+        FILE* _sites = nullptr;
+        uint32_t _registered = 0;
+    };
 
     Firebolt::Error Logger::SetLogLevel(Logger::LogLevel logLevel)
     {
         ASSERT(logLevel < Logger::LogLevel::MaxLevel);
         Firebolt::Error status = Firebolt::Error::General;
         if (logLevel < Logger::LogLevel::MaxLevel) {
-            _logLevel = logLevel;
+            for (std::atomic<LogLevel>& level : _logLevels) {
+                level = logLevel;
+            }
+            status = Firebolt::Error::None;
+        }
+        return status;
+    }
+
+    Firebolt::Error Logger::SetLogLevel(Logger::Category category, Logger::LogLevel logLevel)
+    {
+        ASSERT(logLevel < Logger::LogLevel::MaxLevel);
+        Firebolt::Error status = Firebolt::Error::General;
+        if ((logLevel < Logger::LogLevel::MaxLevel) && (category < Logger::Category::MaxCategory)) {
+            _logLevels[static_cast<uint8_t>(category)] = logLevel;
             status = Firebolt::Error::None;
         }
         return status;
     }
 
-    void Logger::Log(LogLevel logLevel, Category category, const std::string& module, const std::string file, const std::string function, const uint16_t line, const std::string& format, ...)
+    void Logger::SetRateLimit(const uint32_t burst, const uint32_t rate)
+    {
+        _burst = std::max(burst, 1u);
+        _interval = (rate == 0) ? 0 : (1000000 / rate);
+    }
+
+    // A token bucket, kept as the time it is full again
+    bool Logger::Admit(Site& site)
+    {
+        const uint64_t interval = _interval.load(std::memory_order_relaxed);
+        if (interval == 0) {
+            return true;
+        }
+        const uint64_t tolerance = interval * (_burst.load(std::memory_order_relaxed) - 1);
+        const uint64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        uint64_t due = site.due.load(std::memory_order_relaxed);
+        uint64_t next;
+        do {
+            const uint64_t start = std::max(due, now);
+            if ((start - now) > tolerance) {
+                site.suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            next = start + interval;
+        } while (site.due.compare_exchange_weak(due, next, std::memory_order_relaxed) == false);
+        return true;
+    }
+
+    void Logger::SetMode(Logger::Mode mode)
+    {
+        if ((mode == Mode::Binary) && (BinaryFile::Instance().IsOpen() == false)) {
+            // Nowhere to write to
+            mode = Mode::Sync;
+        }
+        if (mode == Mode::Async) {
+            Backend::Instance().Start();
+            _mode = mode;
+        } else {
+            _mode = mode;
+            Backend::Instance().Stop();
+        }
+    }
+
+    Firebolt::Error Logger::SetBinaryLog(const std::string& path, const uint32_t size)
+    {
+        return BinaryFile::Instance().Open(path, size);
+    }
+
+    uint32_t Logger::Register(Site& site, const std::string& module, const char* format)
     {
-        if (logLevel <= _logLevel) {
+        return BinaryFile::Instance().Register(site, module, format);
+    }
+
+    void Logger::Append(const uint32_t site, const Payload& payload)
+    {
+        BinaryFile::Instance().Append(site, payload);
+    }
+
+    uint64_t Logger::Dropped()
+    {
+        return Backend::Instance().Dropped();
+    }
+
+    void Logger::Log(LogLevel logLevel, Category category, const std::string& module, const char* file, const char* function, const uint16_t line, const char* format, ...)
+    {
+        if (IsEnabled(logLevel, category)) {
+            // Not a static log statement, nothing may refer to it once returned so it is written here
+            const Site site(logLevel, category, file, function, line);
+            Record record;
+            record.Fill(site, module);
             va_list arg;
-            char msg[Logger::MaxBufSize];
             va_start(arg, format);
-            int length = vsnprintf(msg, Logger::MaxBufSize, format.c_str(), arg);
+            vsnprintf(record.message, sizeof(record.message), format, arg);
             va_end(arg);
+            Write(record);
+        }
+    }
 
-            uint32_t position = (length >= Logger::MaxBufSize) ? (Logger::MaxBufSize - 1) : length;
-            msg[position] = '\0';
-
-            char formattedMsg[Logger::MaxBufSize];
-            const string time = WPEFramework::Core::Time::Now().ToTimeOnly(true);
-            const string categoryName =  WPEFramework::Core::EnumerateType<Logger::Category>(category).Data();
-            const string levelName =     WPEFramework::Core::EnumerateType<Logger::LogLevel>(logLevel).Data();
-
-            static bool colorSet     = false;
-            static char colorOn[16]  = { 0 };
-            static char colorOff[16] = { 0 };
-            if (!colorSet) {
-                colorSet = true;
-                if (isatty(fileno(stderr)) == 1) {
-                    strncpy(colorOn,  "\033[1;32m", 15);
-                    strncpy(colorOff, "\033[0m",    15);
-                }
+    void Logger::Log(Site& site, const std::string& module, const char* format, ...)
+    {
+        if (Admit(site) == true) {
+            uint32_t suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+            if (suppressed != 0) {
+                Print(site, module, "%u messages suppressed", suppressed);
             }
+            va_list arg;
+            va_start(arg, format);
+            Emit(site, module, format, arg);
+            va_end(arg);
+        }
+    }
+
+    void Logger::Print(const Site& site, const std::string& module, const char* format, ...)
+    {
+        va_list arg;
+        va_start(arg, format);
+        Emit(site, module, format, arg);
+        va_end(arg);
+    }
+
+    void Logger::Emit(const Site& site, const std::string& module, const char* format, va_list arguments)
+    {
+        if (_mode.load(std::memory_order_relaxed) == Mode::Async) {
+            // Only the message is formatted here, it cannot be deferred as its arguments may not outlive this call
+            Backend::Instance().Push(site, module, format, arguments);
+        } else {
+            Record record;
+            record.Fill(site, module);
+            vsnprintf(record.message, sizeof(record.message), format, arguments);
+            Write(record);
+        }
+    }
+
+    void Logger::Write(const Record& record)
+    {
+        // Looked up once rather than for every message
+        static const std::array<string, static_cast<uint8_t>(LogLevel::MaxLevel)> levelNames = []() {
+            std::array<string, static_cast<uint8_t>(LogLevel::MaxLevel)> names;
+            for (uint8_t index = 0; index < names.size(); ++index) {
+                names[index] = WPEFramework::Core::EnumerateType<Logger::LogLevel>(static_cast<LogLevel>(index)).Data();
+            }
+            return names;
+        }();
+        static const std::array<string, static_cast<uint8_t>(Category::MaxCategory)> categoryNames = []() {
+            std::array<string, static_cast<uint8_t>(Category::MaxCategory)> names;
+            for (uint8_t index = 0; index < names.size(); ++index) {
+                names[index] = WPEFramework::Core::EnumerateType<Logger::Category>(static_cast<Category>(index)).Data();
+            }
+            return names;
+        }();
+
+        const Site& site = *record.site;
+        char formattedMsg[Logger::MaxBufSize];
+        const string time = WPEFramework::Core::Time(record.time).ToTimeOnly(true);
+        const string& categoryName = categoryNames[static_cast<uint8_t>(site.category)];
+        const string& levelName = levelNames[static_cast<uint8_t>(site.level)];
+        // Only the file name is printed
+        const char* separator = strrchr(site.file, '/');
+        const char* fileName = (separator != nullptr) ? (separator + 1) : site.file;
+
+        static bool colorSet     = false;
+        static char colorOn[16]  = { 0 };
+        static char colorOff[16] = { 0 };
+        if (!colorSet) {
+            colorSet = true;
+            if (isatty(fileno(stderr)) == 1) {
+                strncpy(colorOn,  "\033[1;32m", 15);
+                strncpy(colorOff, "\033[0m",    15);
+            }
+        }
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wformat-truncation"
-            if (categoryName.empty() != true) {
-                snprintf(formattedMsg, sizeof(formattedMsg), "%s%s: [%s][%s]:[%s][%s:%d](%s)<PID:%d><TID:%ld> : %s%s\n", colorOn, time.c_str(), levelName.c_str(), categoryName.c_str(), module.c_str(), WPEFramework::Core::File::FileName(file).c_str(), line, function.c_str(), TRACE_PROCESS_ID, TRACE_THREAD_ID, msg, colorOff);
-            } else {
-                snprintf(formattedMsg, sizeof(formattedMsg), "%s%s: [%s][%s][%s:%d](%s)<PID:%d><TID:%ld> : %s%s\n", colorOn, time.c_str(), levelName.c_str(), module.c_str(), WPEFramework::Core::File::FileName(file).c_str(), line, function.c_str(), TRACE_PROCESS_ID, TRACE_THREAD_ID, msg, colorOff);
-            }
-#pragma GCC diagnostic pop
-            LOG_MESSAGE(formattedMsg);
+        if (categoryName.empty() != true) {
+            snprintf(formattedMsg, sizeof(formattedMsg), "%s%s: [%s][%s]:[%s][%s:%d](%s)<PID:%d><TID:%ld> : %s%s\n", colorOn, time.c_str(), levelName.c_str(), categoryName.c_str(), record.module, fileName, site.line, site.function, TRACE_PROCESS_ID, record.thread, record.message, colorOff);
+        } else {
+            snprintf(formattedMsg, sizeof(formattedMsg), "%s%s: [%s][%s][%s:%d](%s)<PID:%d><TID:%ld> : %s%s\n", colorOn, time.c_str(), levelName.c_str(), record.module, fileName, site.line, site.function, TRACE_PROCESS_ID, record.thread, record.message, colorOff);
         }
+#pragma GCC diagnostic pop
+        LOG_MESSAGE(formattedMsg);
     }
 }
-
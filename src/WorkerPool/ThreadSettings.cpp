@@ -0,0 +1,102 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ThreadSettings.h"
+#include "Logger.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace FireboltSDK::Transport {
+
+    namespace {
+        // Parses a "0-1,3" CPU list, returns false on malformed input
+        bool ParseCpuList(const std::string& list, cpu_set_t& cpus)
+        {
+            CPU_ZERO(&cpus);
+            const char* cursor = list.c_str();
+            while (*cursor != '\0') {
+                char* end;
+                long first = std::strtol(cursor, &end, 10);
+                if ((end == cursor) || (first < 0)) {
+                    return false;
+                }
+                long last = first;
+                cursor = end;
+                if (*cursor == '-') {
+                    last = std::strtol(cursor + 1, &end, 10);
+                    if ((end == cursor + 1) || (last < first)) {
+                        return false;
+                    }
+                    cursor = end;
+                }
+                for (long cpu = first; (cpu <= last) && (cpu < CPU_SETSIZE); ++cpu) {
+                    CPU_SET(cpu, &cpus);
+                }
+                if (*cursor == ',') {
+                    ++cursor;
+                } else if (*cursor != '\0') {
+                    return false;
+                }
+            }
+            return (CPU_COUNT(&cpus) != 0);
+        }
+    }
+
+    void ThreadSettings::Apply(const uint8_t index) const
+    {
+        if (Name.empty() == false) {
+            // The kernel keeps 15 characters
+            std::string name = (Name + '-' + std::to_string(index)).substr(0, 15);
+            pthread_setname_np(pthread_self(), name.c_str());
+        }
+
+        if (Affinity.empty() == false) {
+            cpu_set_t cpus;
+            if (ParseCpuList(Affinity, cpus) == false) {
+                FIREBOLT_LOG_WARNING(Logger::Category::OpenRPC, "ThreadSettings", "Invalid affinity \"%s\"", Affinity.c_str());
+            } else {
+                int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+                if (result != 0) {
+                    FIREBOLT_LOG_WARNING(Logger::Category::OpenRPC, "ThreadSettings", "Affinity \"%s\" not applied: %s", Affinity.c_str(), strerror(result));
+                }
+            }
+        }
+
+        if (Scheduling == Policy::Fifo) {
+            sched_param parameters = {};
+            parameters.sched_priority = Priority;
+            int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters);
+            if (result != 0) {
+                FIREBOLT_LOG_WARNING(Logger::Category::OpenRPC, "ThreadSettings", "SCHED_FIFO priority %d not applied: %s", Priority, strerror(result));
+            }
+        } else if (Priority != 0) {
+            // The nice level is per thread on Linux, addressed by its tid
+            if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), Priority) != 0) {
+                FIREBOLT_LOG_WARNING(Logger::Category::OpenRPC, "ThreadSettings", "Nice level %d not applied: %s", Priority, strerror(errno));
+            }
+        }
+    }
+}
@@ -0,0 +1,342 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+namespace FireboltSDK::Transport {
+
+    namespace {
+        // Pool and worker index of the calling thread, when it is a worker
+        struct Current {
+            const WorkStealingPool* pool;
+            uint8_t index;
+        };
+        thread_local Current current = { nullptr, 0 };
+
+        struct Start {
+            WorkStealingPool* pool;
+            uint8_t index;
+        };
+    }
+
+    WorkStealingPool::WorkStealingPool(const uint8_t threads, const uint32_t stackSize, WPEFramework::Core::ThreadPool::IDispatcher* dispatcher, const Elasticity& elasticity)
+        : _dispatcher(dispatcher)
+        , _stackSize(stackSize)
+        , _minThreads(std::max<uint8_t>(threads, 1))
+        , _spawnThreshold(elasticity.SpawnThreshold)
+        , _idleTimeout(elasticity.IdleTimeout)
+        , _workers()
+        , _injectionLock()
+        , _injection()
+        , _pending(0)
+        , _idleLock()
+        , _idle()
+        , _running(false)
+        , _idleCount(0)
+        , _activeCount(0)
+        , _spawned(0)
+        , _retired(0)
+        , _runningLock()
+        , _finished()
+    {
+        ASSERT(dispatcher != nullptr);
+        for (uint8_t index = 0; index < std::max(_minThreads, elasticity.MaxThreads); ++index) {
+            _workers.emplace_back(new Worker());
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        Stop();
+    }
+
+    void WorkStealingPool::Run()
+    {
+        std::lock_guard<std::mutex> lock(_idleLock);
+        if (_running == true) {
+            return;
+        }
+        _running = true;
+        while (_activeCount < _minThreads) {
+            Spawn();
+        }
+    }
+
+    void WorkStealingPool::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_idleLock);
+            _running = false;
+        }
+        _idle.notify_all();
+
+        // No thread is spawned once stopped, so the workers can be joined without the lock.
+        // Each of them has left its slot inactive, Run() spawns them again.
+        for (auto& worker : _workers) {
+            if (worker->started == true) {
+                pthread_join(worker->thread, nullptr);
+                worker->started = false;
+            }
+        }
+    }
+
+    void WorkStealingPool::Submit(const Job& job)
+    {
+        ASSERT(job.IsValid() == true);
+
+        // Counted before it can be taken, so that a worker taking it never brings the count below 0
+        _pending.fetch_add(1, std::memory_order_release);
+
+        Clock::time_point now = Clock::now();
+        bool backlog = false;
+        if (current.pool == this) {
+            // Submitted by one of our workers, likely a follow-up of its job, keep it close
+            Worker& worker = *_workers[current.index];
+            std::lock_guard<std::mutex> lock(worker.lock);
+            worker.jobs.push_back({ job, now });
+        } else {
+            std::lock_guard<std::mutex> lock(_injectionLock);
+            _injection.push_back({ job, now });
+            backlog = ((now - _injection.front().enqueued) > _spawnThreshold);
+        }
+        WakeOne();
+
+        if ((backlog == true) && (IsElastic() == true)) {
+            Grow();
+        }
+    }
+
+    uint32_t WorkStealingPool::Revoke(const Job& job, const uint32_t waitTime)
+    {
+        if (Remove(job) == true) {
+            return WPEFramework::Core::ERROR_NONE;
+        }
+
+        std::unique_lock<std::mutex> lock(_runningLock);
+        auto isRunning = [this, &job]() {
+            for (uint8_t index = 0; index < _workers.size(); ++index) {
+                if ((_workers[index]->running == job) && ((current.pool != this) || (current.index != index))) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        if (isRunning() == false) {
+            // Not queued, or revoked by the very job being dispatched
+            return WPEFramework::Core::ERROR_UNKNOWN_KEY;
+        }
+        if (waitTime == WPEFramework::Core::infinite) {
+            _finished.wait(lock, [&isRunning]() { return isRunning() == false; });
+            return WPEFramework::Core::ERROR_NONE;
+        }
+        return (_finished.wait_for(lock, std::chrono::milliseconds(waitTime), [&isRunning]() { return isRunning() == false; })
+            ? WPEFramework::Core::ERROR_NONE : WPEFramework::Core::ERROR_TIMEDOUT);
+    }
+
+    WorkStealingPool::Sizing WorkStealingPool::Size() const
+    {
+        Sizing size;
+        size.Min = _minThreads;
+        size.Max = static_cast<uint8_t>(_workers.size());
+        size.Current = _activeCount.load(std::memory_order_relaxed);
+        size.Spawned = _spawned.load(std::memory_order_relaxed);
+        size.Retired = _retired.load(std::memory_order_relaxed);
+        return size;
+    }
+
+    /* static */ void* WorkStealingPool::Process(void* argument)
+    {
+        Start* start = static_cast<Start*>(argument);
+        WorkStealingPool* pool = start->pool;
+        uint8_t index = start->index;
+        delete start;
+
+        pool->Process(index);
+        return nullptr;
+    }
+
+    void WorkStealingPool::Process(const uint8_t index)
+    {
+        current = { this, index };
+        _dispatcher->Initialize();
+
+        Worker& worker = *_workers[index];
+        Entry entry;
+        while (true) {
+            if (Take(index, entry) == true) {
+                if ((IsElastic() == true) && ((Clock::now() - entry.enqueued) > _spawnThreshold)) {
+                    // Jobs are waiting too long, the others may be as well
+                    Grow();
+                }
+                {
+                    std::lock_guard<std::mutex> lock(_runningLock);
+                    worker.running = entry.job;
+                }
+                _dispatcher->Dispatch(&(*entry.job));
+                {
+                    std::lock_guard<std::mutex> lock(_runningLock);
+                    worker.running = Job();
+                }
+                _finished.notify_all();
+                entry.job = Job();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_idleLock);
+            auto hasWork = [this]() { return (_running == false) || (_pending.load(std::memory_order_acquire) != 0); };
+            ++_idleCount;
+            bool woken = true;
+            if (IsElastic() == true) {
+                woken = _idle.wait_for(lock, _idleTimeout, hasWork);
+            } else {
+                _idle.wait(lock, hasWork);
+            }
+            --_idleCount;
+            if (_running == false) {
+                // Stopped, the slot is free for the next Run()
+                worker.active = false;
+                --_activeCount;
+                break;
+            }
+            if ((woken == false) && (_activeCount > _minThreads)) {
+                // Idle for long enough, the pool shrinks back; the slot is joined when reused
+                worker.active = false;
+                --_activeCount;
+                _retired.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+
+        _dispatcher->Deinitialize();
+        current = { nullptr, 0 };
+    }
+
+    bool WorkStealingPool::Take(const uint8_t index, Entry& entry)
+    {
+        // Own deque first, oldest job first so that submission order is mostly kept
+        {
+            Worker& worker = *_workers[index];
+            std::lock_guard<std::mutex> lock(worker.lock);
+            if (worker.jobs.empty() == false) {
+                entry = std::move(worker.jobs.front());
+                worker.jobs.pop_front();
+                _pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(_injectionLock);
+            if (_injection.empty() == false) {
+                entry = std::move(_injection.front());
+                _injection.pop_front();
+                _pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        // Steal the newest job of a busy sibling, starting with the next one to spread thefts
+        for (uint8_t offset = 1; offset < _workers.size(); ++offset) {
+            Worker& victim = *_workers[(index + offset) % _workers.size()];
+            std::lock_guard<std::mutex> lock(victim.lock);
+            if (victim.jobs.empty() == false) {
+                entry = std::move(victim.jobs.back());
+                victim.jobs.pop_back();
+                _pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool WorkStealingPool::Remove(const Job& job)
+    {
+        auto erase = [this, &job](std::deque<Entry>& jobs) {
+            for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+                if (it->job == job) {
+                    jobs.erase(it);
+                    _pending.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(_injectionLock);
+            if (erase(_injection) == true) {
+                return true;
+            }
+        }
+        for (auto& worker : _workers) {
+            std::lock_guard<std::mutex> lock(worker->lock);
+            if (erase(worker->jobs) == true) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkStealingPool::WakeOne()
+    {
+        // Taking the lock orders this with a worker checking _pending before it sleeps
+        {
+            std::lock_guard<std::mutex> lock(_idleLock);
+        }
+        _idle.notify_one();
+    }
+
+    void WorkStealingPool::Grow()
+    {
+        std::lock_guard<std::mutex> lock(_idleLock);
+        // An idle worker is about to pick the backlog up anyway
+        if ((_running == true) && (_idleCount == 0) && (_activeCount < _workers.size())) {
+            Spawn();
+            _spawned.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void WorkStealingPool::Spawn()
+    {
+        auto slot = std::find_if(_workers.begin(), _workers.end(), [](const std::unique_ptr<Worker>& worker) { return worker->active == false; });
+        ASSERT(slot != _workers.end());
+        uint8_t index = static_cast<uint8_t>(slot - _workers.begin());
+        Worker& worker = **slot;
+
+        if (worker.started == true) {
+            // Retired, it has left its loop already and does not take the lock anymore
+            pthread_join(worker.thread, nullptr);
+            worker.started = false;
+        }
+
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+        if (_stackSize != 0) {
+            pthread_attr_setstacksize(&attributes, _stackSize);
+        }
+        worker.started = (pthread_create(&worker.thread, &attributes, &WorkStealingPool::Process, new Start { this, index }) == 0);
+        pthread_attr_destroy(&attributes);
+        ASSERT(worker.started == true);
+
+        if (worker.started == true) {
+            worker.active = true;
+            ++_activeCount;
+        }
+    }
+}
@@ -21,6 +21,117 @@
 
 namespace Firebolt::Helpers
 {
+namespace
+{
+bool isWhitespace(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+}
+
+// Returns where the value starting at 'position' ends, at its ',' or closing ']'
+size_t skipValue(const std::string& text, size_t position)
+{
+    uint32_t depth = 0;
+    bool inString = false;
+    for (; position < text.size(); ++position)
+    {
+        char c = text[position];
+        if (inString)
+        {
+            if (c == '\\')
+            {
+                ++position;
+            }
+            else if (c == '"')
+            {
+                inString = false;
+            }
+            continue;
+        }
+        switch (c)
+        {
+        case '"':
+            inString = true;
+            break;
+        case '{':
+        case '[':
+            ++depth;
+            break;
+        case '}':
+        case ']':
+            if (depth == 0)
+            {
+                return position;
+            }
+            --depth;
+            break;
+        case ',':
+            if (depth == 0)
+            {
+                return position;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return position;
+}
+
+// By the key of the event when it came with a descriptor
+FireboltSDK::Transport::PendingUnsubscription beginUnsubscribe(SubscriptionData& data)
+{
+    if (data.key != FireboltSDK::Transport::InvalidAtom)
+    {
+        return FireboltSDK::Transport::Event::Instance().BeginUnsubscribe(data.key, data.eventName, &data);
+    }
+    return FireboltSDK::Transport::Event::Instance().BeginUnsubscribe(data.eventName, &data);
+}
+} // namespace
+
+ArrayElements::ArrayElements(const std::string& text) : text_(text), position_(0)
+{
+    while ((position_ < text_.size()) && isWhitespace(text_[position_]))
+    {
+        ++position_;
+    }
+    // Anything but an array has no elements
+    position_ = ((position_ < text_.size()) && (text_[position_] == '[')) ? (position_ + 1) : text_.size();
+}
+
+size_t ArrayElements::count() const
+{
+    ArrayElements elements(*this);
+    std::string_view element;
+    size_t result = 0;
+    while (elements.next(element))
+    {
+        ++result;
+    }
+    return result;
+}
+
+bool ArrayElements::next(std::string_view& element)
+{
+    while ((position_ < text_.size()) && isWhitespace(text_[position_]))
+    {
+        ++position_;
+    }
+    if ((position_ >= text_.size()) || (text_[position_] == ']'))
+    {
+        return false;
+    }
+    size_t end = skipValue(text_, position_);
+    size_t last = end;
+    while ((last > position_) && isWhitespace(text_[last - 1]))
+    {
+        --last;
+    }
+    element = std::string_view(text_).substr(position_, last - position_);
+    position_ = ((end < text_.size()) && (text_[end] == ',')) ? (end + 1) : end;
+    return true;
+}
+
 Parameters::Parameters(const std::vector<std::string>& value)
 {
     WPEFramework::Core::JSON::ArrayType<WPEFramework::Core::JSON::Variant> valueArray;
@@ -62,23 +173,88 @@ SubscriptionHelper::~SubscriptionHelper()
 
 void SubscriptionHelper::unsubscribeAll()
 {
-    for (auto& subscription : subscriptions_)
+    std::map<uint64_t, std::shared_ptr<SubscriptionData>> subscriptions;
     {
-        FireboltSDK::Transport::Event::Instance().Unsubscribe(subscription.second.eventName, &subscription.second);
+        std::lock_guard<std::mutex> lock(mutex_);
+        subscriptions.swap(subscriptions_);
+    }
+
+    std::vector<FireboltSDK::Transport::PendingUnsubscription> pending;
+    pending.reserve(subscriptions.size());
+    for (auto& subscription : subscriptions)
+    {
+        pending.push_back(beginUnsubscribe(*subscription.second));
+    }
+    for (auto& unsubscription : pending)
+    {
+        FireboltSDK::Transport::Event::Instance().EndUnsubscribe(unsubscription);
     }
-    subscriptions_.clear();
 }
 
 Result<void> SubscriptionHelper::unsubscribe(uint64_t id)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = subscriptions_.find(id);
-    if (it == subscriptions_.end())
+    std::map<uint64_t, std::shared_ptr<SubscriptionData>>::node_type subscription;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        subscription = subscriptions_.extract(id);
+    }
+    if (subscription.empty())
     {
         return Result<void>{Error::General};
     }
-    auto errorStatus{FireboltSDK::Transport::Event::Instance().Unsubscribe(it->second.eventName, &it->second)};
-    subscriptions_.erase(it);
-    return Result<void>{errorStatus};
+    FireboltSDK::Transport::PendingUnsubscription pending = beginUnsubscribe(*subscription.mapped());
+    return Result<void>{FireboltSDK::Transport::Event::Instance().EndUnsubscribe(pending)};
+}
+
+std::vector<Result<SubscriptionId>> SubscriptionHelper::subscribe(SubscriptionBatch&& batch)
+{
+    // The address of their data is what the gateway knows them by
+    std::vector<std::pair<SubscriptionId, std::shared_ptr<SubscriptionData>>> entries;
+    entries.reserve(batch.entries_.size());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : batch.entries_)
+        {
+            SubscriptionId id = currentId_++;
+            subscriptions_.emplace(id, entry.data);
+            entries.emplace_back(id, std::move(entry.data));
+        }
+    }
+
+    std::vector<FireboltSDK::Transport::PendingSubscription> pending;
+    pending.reserve(entries.size());
+    for (size_t index = 0; index < entries.size(); ++index)
+    {
+        pending.push_back(batch.entries_[index].begin(entries[index].second));
+    }
+
+    std::vector<Result<SubscriptionId>> results;
+    results.reserve(entries.size());
+    for (size_t index = 0; index < entries.size(); ++index)
+    {
+        Error status = FireboltSDK::Transport::Event::Instance().EndSubscribe(pending[index]);
+        bool present = true;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (status != Error::None)
+            {
+                subscriptions_.erase(entries[index].first);
+            }
+            else
+            {
+                present = (subscriptions_.find(entries[index].first) != subscriptions_.end());
+            }
+        }
+        if (!present)
+        {
+            // unsubscribeAll() ran meanwhile, it could not undo what was not done yet
+            FireboltSDK::Transport::PendingUnsubscription undo = FireboltSDK::Transport::Event::Instance().BeginUnsubscribe(
+                pending[index].key, pending[index].event, pending[index].usercb);
+            FireboltSDK::Transport::Event::Instance().EndUnsubscribe(undo);
+            status = Error::General;
+        }
+        results.push_back((status == Error::None) ? Result<SubscriptionId>{entries[index].first} : Result<SubscriptionId>{status});
+    }
+    return results;
 }
 } // namespace Firebolt::Transport
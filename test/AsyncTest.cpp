@@ -0,0 +1,133 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Accessor.h"
+#include "Async.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace FireboltSDK::Transport;
+
+namespace {
+
+struct Calls
+{
+    std::mutex mtx;
+    std::condition_variable done;
+    uint32_t answered = 0;
+    uint32_t failed = 0;
+};
+
+void onName(void* usercb, void* response, Firebolt::Error status)
+{
+    Calls& calls = *static_cast<Calls*>(usercb);
+    WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::String>* name = static_cast<WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::String>*>(response);
+    std::lock_guard lck(calls.mtx);
+    if (status == Firebolt::Error::None && name != nullptr && (*name)->Value() == "Living Room") {
+        ++calls.answered;
+    } else {
+        ++calls.failed;
+    }
+    calls.done.notify_one();
+}
+
+// A plain job for the worker pool, telling when it ran
+class Probe : public WPEFramework::Core::IDispatch
+{
+public:
+    Probe(std::promise<void>& ran)
+        : _ran(ran)
+    {
+    }
+
+    void Dispatch() override
+    {
+        _ran.set_value();
+    }
+
+private:
+    std::promise<void>& _ran;
+};
+
+} // namespace
+
+class AsyncTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        // Default worker pool, three threads
+        Accessor::Instance(R"({"waitTime":1000,"logLevel":"Warning","wsUrl":"ws://127.0.0.1:9998"})");
+        ASSERT_EQ(Accessor::Instance().Connect(nullptr), Firebolt::Error::None);
+    }
+
+    static void TearDownTestSuite()
+    {
+        Accessor::Instance().Disconnect();
+        Accessor::Dispose();
+    }
+};
+
+// Outstanding calls hold no thread: all of them are in flight at once, far more than the
+// pool has threads, the pool still runs other jobs meanwhile and all of them get answered
+TEST_F(AsyncTest, ThousandConcurrentInvokes)
+{
+    static constexpr uint32_t Callers = 4;
+    static constexpr uint32_t CallsEach = 250;
+
+    Calls calls;
+    Client::HoldAnswers();
+    std::vector<std::thread> callers;
+    for (uint32_t i = 0; i < Callers; ++i) {
+        callers.emplace_back([&calls]() {
+            for (uint32_t j = 0; j < CallsEach; ++j) {
+                JsonObject parameters;
+                EXPECT_EQ(Async::Instance().Invoke<WPEFramework::Core::JSON::String>("device.name", parameters, onName, &calls), Firebolt::Error::None);
+            }
+        });
+    }
+    for (std::thread& caller : callers) {
+        caller.join();
+    }
+
+    // Every Invoke() returned while none was answered yet
+    {
+        std::lock_guard lck(calls.mtx);
+        EXPECT_EQ(calls.answered + calls.failed, 0u);
+    }
+
+    std::promise<void> ran;
+    WPEFramework::Core::IWorkerPool::Instance().Submit(WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Probe>::Create(ran)));
+    EXPECT_EQ(ran.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    Client::ReleaseAnswers();
+
+    std::unique_lock lck(calls.mtx);
+    bool finished = calls.done.wait_for(lck, std::chrono::seconds(10), [&calls]() { return calls.answered + calls.failed == Callers * CallsEach; });
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(calls.answered, Callers * CallsEach);
+    EXPECT_EQ(calls.failed, 0u);
+}
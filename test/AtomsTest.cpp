@@ -0,0 +1,91 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/atoms.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace FireboltSDK::Transport;
+
+TEST(AtomsTest, InternIsStable)
+{
+    Atoms& atoms = Atoms::Instance();
+    AtomId id = atoms.Intern("atomsTest.stable");
+    EXPECT_NE(id, InvalidAtom);
+    EXPECT_EQ(atoms.Intern("atomsTest.stable"), id);
+    EXPECT_EQ(atoms.Find("atomsTest.stable"), id);
+    EXPECT_EQ(atoms.Name(id), "atomsTest.stable");
+}
+
+TEST(AtomsTest, FindUnknown)
+{
+    Atoms& atoms = Atoms::Instance();
+    EXPECT_EQ(atoms.Find("atomsTest.neverInterned"), InvalidAtom);
+    EXPECT_EQ(atoms.Name(InvalidAtom), "");
+}
+
+TEST(AtomsTest, CompileTimeHash)
+{
+    constexpr uint64_t hash = AtomHash("atomsTest.hashed");
+    AtomId id = Atoms::Instance().Intern("atomsTest.hashed", hash);
+    EXPECT_EQ(Atoms::Instance().Find("atomsTest.hashed"), id);
+}
+
+TEST(AtomsTest, SurvivesGrowth)
+{
+    Atoms& atoms = Atoms::Instance();
+    std::vector<AtomId> ids;
+    for (int i = 0; i < 1000; ++i) {
+        ids.push_back(atoms.Intern("atomsTest.grow." + std::to_string(i)));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(atoms.Find("atomsTest.grow." + std::to_string(i)), ids[i]);
+    }
+    EXPECT_EQ(std::set<AtomId>(ids.begin(), ids.end()).size(), ids.size());
+}
+
+TEST(AtomsTest, ConcurrentIntern)
+{
+    static constexpr int Threads = 8;
+    static constexpr int Names = 500;
+
+    Atoms& atoms = Atoms::Instance();
+    std::vector<std::vector<AtomId>> ids(Threads, std::vector<AtomId>(Names));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.emplace_back([&atoms, &ids, t]() {
+            for (int i = 0; i < Names; ++i) {
+                ids[t][i] = atoms.Intern("atomsTest.concurrent." + std::to_string(i));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int i = 0; i < Names; ++i) {
+        EXPECT_NE(ids[0][i], InvalidAtom);
+        for (int t = 1; t < Threads; ++t) {
+            EXPECT_EQ(ids[t][i], ids[0][i]);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CompletionQueue.h"
+
+#include <gtest/gtest.h>
+
+#include <poll.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace FireboltSDK::Transport;
+
+TEST(CompletionQueueTest, DrainRunsOnCallingThread)
+{
+    CompletionQueue queue;
+    std::thread::id ranOn;
+    queue.Post([&ranOn]() { ranOn = std::this_thread::get_id(); });
+    EXPECT_EQ(queue.Drain(), 1u);
+    EXPECT_EQ(ranOn, std::this_thread::get_id());
+    EXPECT_EQ(queue.Drain(), 0u);
+}
+
+TEST(CompletionQueueTest, DescriptorSignalsPostedTasks)
+{
+    CompletionQueue queue;
+    ASSERT_NE(queue.Descriptor(), -1);
+
+    struct pollfd fd = { queue.Descriptor(), POLLIN, 0 };
+    EXPECT_EQ(::poll(&fd, 1, 0), 0);
+    queue.Post([]() {});
+    EXPECT_EQ(::poll(&fd, 1, 0), 1);
+    queue.Drain();
+    EXPECT_EQ(::poll(&fd, 1, 0), 0);
+}
+
+// Tasks of each producer run in the order they were posted, and all of them run
+TEST(CompletionQueueTest, MultipleProducersKeepTheirOrder)
+{
+    static constexpr uint32_t Producers = 8;
+    static constexpr uint32_t TasksEach = 10000;
+
+    CompletionQueue queue;
+    std::vector<uint32_t> last(Producers, 0);
+    uint32_t outOfOrder = 0;
+    std::atomic<uint32_t> producing { Producers };
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < Producers; ++p) {
+        producers.emplace_back([&, p]() {
+            for (uint32_t i = 1; i <= TasksEach; ++i) {
+                queue.Post([&last, &outOfOrder, p, i]() {
+                    if (last[p] + 1 != i) {
+                        ++outOfOrder;
+                    }
+                    last[p] = i;
+                });
+            }
+            --producing;
+        });
+    }
+
+    uint32_t ran = 0;
+    struct pollfd fd = { queue.Descriptor(), POLLIN, 0 };
+    while (producing > 0 || ran < Producers * TasksEach) {
+        ::poll(&fd, 1, 10);
+        ran += queue.Drain();
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_EQ(ran, Producers * TasksEach);
+    EXPECT_EQ(outOfOrder, 0u);
+    for (uint32_t p = 0; p < Producers; ++p) {
+        EXPECT_EQ(last[p], TasksEach);
+    }
+}
+
+TEST(CompletionQueueTest, LeftOverTasksAreDropped)
+{
+    uint32_t ran = 0;
+    {
+        CompletionQueue queue;
+        queue.Post([&ran]() { ++ran; });
+    }
+    EXPECT_EQ(ran, 0u);
+}
@@ -0,0 +1,103 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/descriptor.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace FireboltSDK::Transport;
+
+namespace {
+struct DeviceName {
+    static constexpr std::string_view name = "device.name";
+    using JsonType = void;
+    using PropertyType = std::string;
+};
+
+struct LifecycleOnBackground {
+    static constexpr std::string_view name = "lifecycle.onBackground";
+    using JsonType = void;
+    using PropertyType = std::string;
+};
+
+struct DiscoveryLaunch {
+    static constexpr std::string_view name = "discovery.launch";
+    using JsonType = void;
+    using PropertyType = bool;
+};
+
+struct Undotted {
+    static constexpr std::string_view name = "ping";
+    using JsonType = void;
+    using PropertyType = bool;
+};
+
+using DeviceNameProperty = PropertyDescriptor<DeviceName>;
+using BackgroundEvent = MethodDescriptor<LifecycleOnBackground>;
+using LaunchMethod = MethodDescriptor<DiscoveryLaunch>;
+using UndottedProperty = PropertyDescriptor<Undotted>;
+
+// Worked out by the compiler, these fail the build rather than the test
+static_assert(DeviceNameProperty::Name == "device.name");
+static_assert(DeviceNameProperty::EventName == "device.onNameChanged");
+static_assert(DeviceNameProperty::EventKey == "device.nameChanged");
+static_assert(DeviceNameProperty::NameHash == AtomHash("device.name"));
+static_assert(DeviceNameProperty::EventKeyHash == AtomHash("device.nameChanged"));
+
+static_assert(BackgroundEvent::EventName == "lifecycle.onBackground");
+static_assert(BackgroundEvent::EventKey == "lifecycle.background");
+
+static_assert(LaunchMethod::EventName == "discovery.launch");
+static_assert(LaunchMethod::EventKey == "discovery.launch");
+
+// Nothing to derive from a name without a module
+static_assert(UndottedProperty::EventName == "ping");
+static_assert(UndottedProperty::EventKey == "ping");
+
+static_assert(Names::eventKey<Names::eventKeySize("a.on")>("a.on").view() == "a.on");
+static_assert(Names::eventKey<Names::eventKeySize("a.onX")>("a.onX").view() == "a.x");
+static_assert(Names::eventKey<Names::eventKeySize("a.online")>("a.online").view() == "a.line");
+static_assert(Names::propertyEvent<Names::propertyEventSize("a.")>("a.").view() == "a.");
+} // namespace
+
+TEST(DescriptorTest, KeyIsInternedOnce)
+{
+    AtomId key = DeviceNameProperty::Key();
+    EXPECT_NE(key, InvalidAtom);
+    EXPECT_EQ(DeviceNameProperty::Key(), key);
+    EXPECT_EQ(Atoms::Instance().Find("device.nameChanged"), key);
+    EXPECT_EQ(Atoms::Instance().Name(key), "device.nameChanged");
+}
+
+TEST(DescriptorTest, KeyMatchesEventName)
+{
+    // As the Server interns the key of the event name it is given
+    EXPECT_EQ(BackgroundEvent::Key(), Atoms::Instance().Intern("lifecycle.background"));
+    EXPECT_NE(BackgroundEvent::Key(), LaunchMethod::Key());
+}
+
+TEST(DescriptorTest, NameStrings)
+{
+    EXPECT_EQ(DeviceNameProperty::NameString(), "device.name");
+    EXPECT_EQ(DeviceNameProperty::EventNameString(), "device.onNameChanged");
+    // Built once
+    EXPECT_EQ(&DeviceNameProperty::NameString(), &DeviceNameProperty::NameString());
+}
@@ -0,0 +1,82 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/executor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace FireboltSDK::Transport;
+
+namespace {
+
+bool waitFor(const std::function<bool()>& done, std::chrono::milliseconds timeout = std::chrono::seconds(10))
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (done() == false) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Posts 'count' tasks that only return once all of them are running at the same time
+uint32_t runTogether(Executor& executor, uint32_t count, std::chrono::milliseconds timeout)
+{
+    auto started = std::make_shared<std::atomic<uint32_t>>(0);
+    auto released = std::make_shared<std::atomic<bool>>(false);
+    for (uint32_t i = 0; i < count; ++i) {
+        executor.Post([started, released, count]() {
+            started->fetch_add(1);
+            while ((*released == false) && (*started < count)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    waitFor([&]() { return *started == count; }, timeout);
+    uint32_t together = *started;
+    *released = true;
+    return together;
+}
+
+} // namespace
+
+TEST(ExecutorTest, ResizeGrows)
+{
+    Executor executor(1);
+    executor.Resize(4);
+    EXPECT_EQ(runTogether(executor, 4, std::chrono::seconds(10)), 4u);
+}
+
+TEST(ExecutorTest, ResizeShrinks)
+{
+    Executor executor(4);
+    executor.Resize(1);
+    // The retired threads leave once idle, a single one is left to run the tasks
+    EXPECT_EQ(runTogether(executor, 2, std::chrono::milliseconds(200)), 1u);
+
+    std::atomic<bool> ran { false };
+    executor.Post([&ran]() { ran = true; });
+    EXPECT_TRUE(waitFor([&ran]() { return ran == true; }));
+}
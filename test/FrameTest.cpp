@@ -0,0 +1,71 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/frame.h"
+
+#include <gtest/gtest.h>
+
+using namespace FireboltSDK::Transport;
+
+TEST(FrameTest, Classify)
+{
+    WPEFramework::Core::JSONRPC::Message response;
+    response.Id = 1;
+    EXPECT_EQ(Frame(response).Type(), Frame::Kind::Response);
+
+    WPEFramework::Core::JSONRPC::Message event;
+    event.Designator = "frameTest.onEvent";
+    EXPECT_EQ(Frame(event).Type(), Frame::Kind::Event);
+
+    WPEFramework::Core::JSONRPC::Message request;
+    request.Id = 2;
+    request.Designator = "frameTest.provide";
+    EXPECT_EQ(Frame(request).Type(), Frame::Kind::Request);
+
+    WPEFramework::Core::JSONRPC::Message empty;
+    EXPECT_EQ(Frame(empty).Type(), Frame::Kind::Invalid);
+}
+
+TEST(FrameTest, KeyOfUnknownMethod)
+{
+    WPEFramework::Core::JSONRPC::Message event;
+    event.Designator = "frameTest.onNobodyListens";
+    Frame frame(event);
+    EXPECT_EQ(frame.Key(), InvalidAtom);
+
+    AtomId key = Atoms::Instance().Intern("frameTest.onListened");
+    WPEFramework::Core::JSONRPC::Message listened;
+    listened.Designator = "frameTest.onListened";
+    EXPECT_EQ(Frame(listened).Key(), key);
+    // As given, not looked up
+    EXPECT_EQ(Frame(listened, InvalidAtom).Key(), InvalidAtom);
+}
+
+TEST(FrameTest, PayloadCopiedOnce)
+{
+    WPEFramework::Core::JSONRPC::Message event;
+    event.Designator = "frameTest.onCopied";
+    event.Parameters = "{\"value\":1}";
+    Frame frame(event);
+    const std::string& parameters = frame.Parameters();
+    EXPECT_EQ(parameters, "{\"value\":1}");
+    EXPECT_EQ(&frame.Parameters(), &parameters);
+    EXPECT_EQ(&frame.Method(), &frame.Method());
+    EXPECT_EQ(frame.Method(), "frameTest.onCopied");
+}
@@ -0,0 +1,162 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Accessor.h"
+#include "helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace Firebolt::Helpers;
+
+namespace
+{
+std::vector<std::string> elementsOf(const std::string& text)
+{
+    ArrayElements elements(text);
+    std::vector<std::string> result;
+    std::string_view element;
+    while (elements.next(element))
+    {
+        result.emplace_back(element);
+    }
+    return result;
+}
+} // namespace
+
+TEST(HelpersTest, EmptyArray)
+{
+    EXPECT_TRUE(elementsOf("[]").empty());
+    EXPECT_TRUE(elementsOf("  [ \n ]  ").empty());
+    EXPECT_EQ(ArrayElements(std::string("[]")).count(), 0u);
+}
+
+TEST(HelpersTest, NotAnArray)
+{
+    EXPECT_TRUE(elementsOf("").empty());
+    EXPECT_TRUE(elementsOf("   ").empty());
+    EXPECT_TRUE(elementsOf("{\"a\":[1,2]}").empty());
+    EXPECT_TRUE(elementsOf("\"[1,2]\"").empty());
+    EXPECT_TRUE(elementsOf("42").empty());
+}
+
+TEST(HelpersTest, Scalars)
+{
+    EXPECT_EQ(elementsOf("[1,2,3]"), (std::vector<std::string>{"1", "2", "3"}));
+    EXPECT_EQ(elementsOf("[ true , false,null ,-1.5e3 ]"), (std::vector<std::string>{"true", "false", "null", "-1.5e3"}));
+    EXPECT_EQ(elementsOf("[\n\t\"a\",\r\n\t\"b\"\n]"), (std::vector<std::string>{"\"a\"", "\"b\""}));
+}
+
+TEST(HelpersTest, NestedValues)
+{
+    const std::string text = R"([{"a":[1,2],"b":{"c":3}}, [[],[4,[5]]], {}])";
+    EXPECT_EQ(elementsOf(text),
+              (std::vector<std::string>{R"({"a":[1,2],"b":{"c":3}})", "[[],[4,[5]]]", "{}"}));
+}
+
+TEST(HelpersTest, DelimitersInStrings)
+{
+    // Commas, brackets and escaped quotes inside strings do not end the element
+    const std::string text = R"(["a,b", "]", "[{", "say \"hi\", ok", "back\\", {"k":"}],"}])";
+    EXPECT_EQ(elementsOf(text), (std::vector<std::string>{R"("a,b")", R"("]")", R"("[{")", R"("say \"hi\", ok")",
+                                                          R"("back\\")", R"({"k":"}],"})"}));
+}
+
+TEST(HelpersTest, CountLeavesPosition)
+{
+    const std::string text = "[1, [2, 3], \"4\"]";
+    ArrayElements elements(text);
+    EXPECT_EQ(elements.count(), 3u);
+
+    std::string_view element;
+    ASSERT_TRUE(elements.next(element));
+    EXPECT_EQ(element, "1");
+    // Of those not walked yet
+    EXPECT_EQ(elements.count(), 2u);
+    ASSERT_TRUE(elements.next(element));
+    EXPECT_EQ(element, "[2, 3]");
+    ASSERT_TRUE(elements.next(element));
+    EXPECT_EQ(element, "\"4\"");
+    EXPECT_FALSE(elements.next(element));
+    EXPECT_EQ(elements.count(), 0u);
+}
+
+TEST(HelpersTest, Truncated)
+{
+    // What is there is still walked, nothing is read past the end
+    EXPECT_EQ(elementsOf("[1, 2"), (std::vector<std::string>{"1", "2"}));
+    EXPECT_EQ(elementsOf("[\"open"), (std::vector<std::string>{"\"open"}));
+    EXPECT_EQ(elementsOf("[\"escape\\"), (std::vector<std::string>{"\"escape\\"}));
+}
+
+namespace
+{
+struct DeviceName
+{
+    static constexpr std::string_view name = "device.name";
+    using JsonType = WPEFramework::Core::JSON::String;
+    using PropertyType = std::string;
+};
+
+using DeviceNameProperty = FireboltSDK::Transport::PropertyDescriptor<DeviceName>;
+using DeviceNameMethod = FireboltSDK::Transport::MethodDescriptor<DeviceName>;
+} // namespace
+
+// Requests answered by the mocked transport
+class HelpersRequestTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        FireboltSDK::Transport::Accessor::Instance(R"({"waitTime":1000,"logLevel":"Warning","wsUrl":"ws://127.0.0.1:9998"})");
+        ASSERT_EQ(FireboltSDK::Transport::Accessor::Instance().Connect(nullptr), Firebolt::Error::None);
+    }
+
+    static void TearDownTestSuite()
+    {
+        FireboltSDK::Transport::Accessor::Instance().Disconnect();
+        FireboltSDK::Transport::Accessor::Dispose();
+    }
+};
+
+TEST_F(HelpersRequestTest, GetByDescriptor)
+{
+    Firebolt::Result<std::string> byName = get<DeviceName::JsonType, DeviceName::PropertyType>("device.name");
+    Firebolt::Result<std::string> byDescriptor = get<DeviceNameProperty>();
+    ASSERT_TRUE(byName);
+    ASSERT_TRUE(byDescriptor);
+    EXPECT_EQ(*byDescriptor, "Living Room");
+    EXPECT_EQ(*byDescriptor, *byName);
+}
+
+TEST_F(HelpersRequestTest, GetByDescriptorWithParameters)
+{
+    Firebolt::Result<std::string> name = get<DeviceNameProperty>(Parameters());
+    ASSERT_TRUE(name);
+    EXPECT_EQ(*name, "Living Room");
+}
+
+TEST_F(HelpersRequestTest, InvokeByDescriptor)
+{
+    Firebolt::Result<std::string> name = invoke<DeviceNameMethod>(Parameters());
+    ASSERT_TRUE(name);
+    EXPECT_EQ(*name, "Living Room");
+}
@@ -0,0 +1,81 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/scanner.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace FireboltSDK::Transport;
+
+namespace {
+
+std::vector<std::pair<std::string, std::string>> membersOf(const std::string& text, bool& valid)
+{
+    std::vector<std::pair<std::string, std::string>> members;
+    ObjectMembers walker(text);
+    std::string_view name;
+    std::string_view value;
+    while (walker.Next(name, value)) {
+        members.emplace_back(name, value);
+    }
+    valid = walker.Valid();
+    return members;
+}
+
+} // namespace
+
+TEST(ObjectMembersTest, WalksTopLevelMembers)
+{
+    bool valid = false;
+    auto members = membersOf(R"( { "id": 3, "result" : { "a": [1, "}", {"b": null}] } , "s": "x\"," } )", valid);
+    EXPECT_TRUE(valid);
+    ASSERT_EQ(members.size(), 3u);
+    EXPECT_EQ(members[0], (std::pair<std::string, std::string>{ "id", "3" }));
+    EXPECT_EQ(members[1], (std::pair<std::string, std::string>{ "result", R"({ "a": [1, "}", {"b": null}] })" }));
+    EXPECT_EQ(members[2], (std::pair<std::string, std::string>{ "s", R"("x\",")" }));
+}
+
+TEST(ObjectMembersTest, EmptyObject)
+{
+    bool valid = false;
+    EXPECT_TRUE(membersOf("{ }", valid).empty());
+    EXPECT_TRUE(valid);
+}
+
+TEST(ObjectMembersTest, NotAnObject)
+{
+    bool valid = true;
+    EXPECT_TRUE(membersOf("[1, 2]", valid).empty());
+    EXPECT_FALSE(valid);
+    EXPECT_TRUE(membersOf(R"({ "a" 1 })", valid).empty());
+    EXPECT_FALSE(valid);
+    EXPECT_TRUE(membersOf(R"({ "a": })", valid).empty());
+    EXPECT_FALSE(valid);
+}
+
+TEST(ObjectMembersTest, Find)
+{
+    const std::string response = R"({ "jsonrpc": "2.0", "id": 1, "error": { "code": -1, "message": "no" } })";
+    EXPECT_EQ(ObjectMembers::Find(response, "error"), R"({ "code": -1, "message": "no" })");
+    EXPECT_TRUE(ObjectMembers::Find(response, "result").empty());
+}
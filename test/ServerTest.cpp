@@ -0,0 +1,306 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gateway/server.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace FireboltSDK::Transport;
+
+namespace {
+
+// Counts how often a payload gets parsed
+template <int TAG>
+class Payload {
+public:
+    bool FromString(const std::string& text)
+    {
+        _parses.fetch_add(1, std::memory_order_relaxed);
+        _text = text;
+        return true;
+    }
+
+    const std::string& Text() const
+    {
+        return _text;
+    }
+
+    static uint32_t Parses()
+    {
+        return _parses.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::string _text;
+    static std::atomic<uint32_t> _parses;
+};
+
+template <int TAG>
+std::atomic<uint32_t> Payload<TAG>::_parses { 0 };
+
+// What each subscriber was handed, by the address of the object it got
+struct Received {
+    std::set<const void*> objects;
+    std::vector<std::string> texts;
+};
+
+template <typename RESULT>
+void subscribe(Server& server, AtomId key, Received& received, void* usercb, const SubscriptionOptions& options = {})
+{
+    JsonObject parameters;
+    bool first = false;
+    bool fetch = false;
+    std::shared_ptr<ListenState> listen;
+    Firebolt::Error status = server.Subscribe<RESULT>(key, parameters, [&received](void*, const void*, void* response) {
+        WPEFramework::Core::ProxyType<RESULT>& payload = *static_cast<WPEFramework::Core::ProxyType<RESULT>*>(response);
+        received.objects.insert(&(*payload));
+        received.texts.push_back(payload->Text());
+    }, usercb, nullptr, options, first, fetch, listen);
+    ASSERT_EQ(status, Firebolt::Error::None);
+}
+
+} // namespace
+
+TEST(ServerTest, ParsesOncePerResultType)
+{
+    static constexpr uint32_t Subscribers = 10;
+
+    Server server(Config{});
+    AtomId key = server.Key("serverTest.onParsed");
+    std::vector<Received> first(Subscribers);
+    std::vector<Received> second(Subscribers);
+    for (uint32_t i = 0; i < Subscribers; ++i) {
+        subscribe<Payload<1>>(server, key, first[i], &first[i]);
+        subscribe<Payload<2>>(server, key, second[i], &second[i]);
+    }
+
+    server.Notify(key, "\"one\"");
+    EXPECT_EQ(Payload<1>::Parses(), 1u);
+    EXPECT_EQ(Payload<2>::Parses(), 1u);
+
+    // All the subscribers of a type got the very same object, each type its own
+    std::set<const void*> firstObjects;
+    std::set<const void*> secondObjects;
+    for (uint32_t i = 0; i < Subscribers; ++i) {
+        ASSERT_EQ(first[i].texts, std::vector<std::string>{ "\"one\"" });
+        ASSERT_EQ(second[i].texts, std::vector<std::string>{ "\"one\"" });
+        firstObjects.insert(first[i].objects.begin(), first[i].objects.end());
+        secondObjects.insert(second[i].objects.begin(), second[i].objects.end());
+    }
+    EXPECT_EQ(firstObjects.size(), 1u);
+    EXPECT_EQ(secondObjects.size(), 1u);
+    EXPECT_NE(*firstObjects.begin(), *secondObjects.begin());
+
+    // Once per notification, not once for all time
+    server.Notify(key, "\"two\"");
+    EXPECT_EQ(Payload<1>::Parses(), 2u);
+    EXPECT_EQ(Payload<2>::Parses(), 2u);
+    EXPECT_EQ(first[0].texts.back(), "\"two\"");
+}
+
+TEST(ServerTest, ConflatingSubscribersShareThePayload)
+{
+    Server server(Config{});
+    AtomId key = server.Key("serverTest.onConflated");
+    Received plain;
+    Received conflated;
+    SubscriptionOptions options;
+    options.conflate = true;
+    subscribe<Payload<3>>(server, key, plain, &plain);
+    subscribe<Payload<3>>(server, key, conflated, &conflated, options);
+
+    server.Notify(key, "1");
+    EXPECT_EQ(Payload<3>::Parses(), 1u);
+    EXPECT_EQ(plain.objects, conflated.objects);
+}
+
+TEST(ServerTest, SupersededSkipsConflatingSubscribers)
+{
+    Server server(Config{});
+    AtomId key = server.Key("serverTest.onSuperseded");
+    Received plain;
+    Received conflated;
+    SubscriptionOptions options;
+    options.conflate = true;
+    subscribe<Payload<5>>(server, key, plain, &plain);
+    subscribe<Payload<5>>(server, key, conflated, &conflated, options);
+
+    server.Notify(key, "1", true);
+    server.Notify(key, "2", true);
+    server.Notify(key, "3");
+    EXPECT_EQ(plain.texts, (std::vector<std::string>{ "1", "2", "3" }));
+    EXPECT_EQ(conflated.texts, std::vector<std::string>{ "3" });
+}
+
+TEST(ServerTest, UnsubscribedEventIsNotParsed)
+{
+    Server server(Config{});
+    AtomId key = server.Key("serverTest.onNobody");
+    Received received;
+    subscribe<Payload<4>>(server, key, received, &received);
+    bool last = false;
+    EXPECT_EQ(server.Unsubscribe(key, &received, last), Firebolt::Error::None);
+    EXPECT_TRUE(last);
+
+    server.Notify(key, "1");
+    EXPECT_EQ(Payload<4>::Parses(), 0u);
+    EXPECT_TRUE(received.texts.empty());
+}
+
+namespace {
+
+// Shaped as the generated provider requests, with the parameters in their own element
+struct ProviderRequest {
+    void Clear()
+    {
+        wrapped.clear();
+    }
+
+    bool FromString(const std::string& text)
+    {
+        wrapped = text;
+        return true;
+    }
+
+    Payload<6> Parameters;
+    std::string wrapped;
+};
+
+// Without such an element, so it is handed the parameters in '{ "parameters": ... }'
+struct WrappedRequest {
+    void Clear()
+    {
+        text.clear();
+    }
+
+    bool FromString(const std::string& value)
+    {
+        text = value;
+        return true;
+    }
+
+    std::string text;
+};
+
+// What the provider of 'REQUEST' registered under 'method' got for a request carrying 'parameters'
+template <typename REQUEST>
+REQUEST provide(Server& server, const std::string& method, const std::string& parameters)
+{
+    std::promise<REQUEST> handed;
+    JsonObject registration;
+    Firebolt::Error status = server.RegisterProviderInterface<REQUEST>(method, registration, [&handed](void*, void* params) -> std::string {
+        handed.set_value(**static_cast<WPEFramework::Core::ProxyType<REQUEST>*>(params));
+        return "{ \"result\": null }";
+    }, &handed);
+    EXPECT_EQ(status, Firebolt::Error::None);
+
+    server.Request(nullptr, 1, Atoms::Instance().Find(method), parameters);
+    return handed.get_future().get();
+}
+
+} // namespace
+
+TEST(ServerTest, ProviderGetsItsParametersUnwrapped)
+{
+    Server server(Config{});
+    ProviderRequest request = provide<ProviderRequest>(server, "serverTest.provide", "{ \"value\": 1 }");
+    EXPECT_EQ(request.Parameters.Text(), "{ \"value\": 1 }");
+    EXPECT_TRUE(request.wrapped.empty());
+}
+
+TEST(ServerTest, ProviderWithoutParametersElementGetsThemWrapped)
+{
+    Server server(Config{});
+    WrappedRequest request = provide<WrappedRequest>(server, "serverTest.provideWrapped", "{ \"value\": 1 }");
+    EXPECT_EQ(request.text, "{ \"parameters\":{ \"value\": 1 }}");
+}
+
+namespace {
+
+// A result type of its own, so that it gets parsed apart from the others
+template <size_t TAG>
+class Distinct : public WPEFramework::Core::JSON::String {
+};
+
+template <typename RESULT>
+void countDeliveries(Server& server, AtomId key, std::atomic<uint32_t>& delivered, void* usercb)
+{
+    JsonObject parameters;
+    bool first = false;
+    bool fetch = false;
+    std::shared_ptr<ListenState> listen;
+    server.Subscribe<RESULT>(key, parameters, [&delivered](void*, const void*, void* response) {
+        const WPEFramework::Core::ProxyType<RESULT>& value = *static_cast<WPEFramework::Core::ProxyType<RESULT>*>(response);
+        if (value.IsValid() == true) {
+            delivered.fetch_add(1, std::memory_order_relaxed);
+        }
+    }, usercb, nullptr, {}, first, fetch, listen);
+}
+
+template <size_t... TAGS>
+std::chrono::steady_clock::duration fanOut(const char* event, bool shared, uint32_t notifications, const std::string& payload, std::index_sequence<TAGS...>)
+{
+    Server server(Config{});
+    AtomId key = server.Key(event);
+    std::atomic<uint32_t> delivered { 0 };
+    int subscribers[sizeof...(TAGS)];
+    if (shared) {
+        (countDeliveries<Distinct<0>>(server, key, delivered, &subscribers[TAGS]), ...);
+    } else {
+        (countDeliveries<Distinct<TAGS>>(server, key, delivered, &subscribers[TAGS]), ...);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < notifications; ++i) {
+        server.Notify(key, payload);
+    }
+    auto duration = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(delivered.load(), sizeof...(TAGS) * notifications);
+    return duration;
+}
+
+} // namespace
+
+// Ten subscribers of the same type share one parsed payload. Against ten subscribers of
+// distinct types, which cost one parse each as all of them did before.
+TEST(ServerBenchmark, FanOutToTenSubscribers)
+{
+    static constexpr uint32_t Notifications = 20000;
+    const std::string payload = "\"" + std::string(256, 'x') + "\"";
+
+    auto shared = fanOut("serverBenchmark.onShared", true, Notifications, payload, std::make_index_sequence<10>());
+    auto distinct = fanOut("serverBenchmark.onDistinct", false, Notifications, payload, std::make_index_sequence<10>());
+
+    auto ms = [](std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+    };
+    std::cout << "10 subscribers, " << Notifications << " notifications: " << ms(shared) << " ms parsed once, "
+              << ms(distinct) << " ms parsed per subscriber" << std::endl;
+    RecordProperty("sharedMs", static_cast<int>(ms(shared)));
+    RecordProperty("perSubscriberMs", static_cast<int>(ms(distinct)));
+}
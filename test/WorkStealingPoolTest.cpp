@@ -0,0 +1,406 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WorkStealingPool.h"
+#include "WorkerPool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace FireboltSDK::Transport;
+
+namespace {
+
+using Job = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>;
+
+class Task : public WPEFramework::Core::IDispatch {
+public:
+    Task(std::function<void()>&& run)
+        : _run(std::move(run))
+    {
+    }
+
+    void Dispatch() override
+    {
+        _run();
+    }
+
+private:
+    std::function<void()> _run;
+};
+
+Job task(std::function<void()>&& run)
+{
+    return Job(WPEFramework::Core::ProxyType<Task>::Create(std::move(run)));
+}
+
+class Dispatcher : public WPEFramework::Core::ThreadPool::IDispatcher {
+public:
+    void Initialize() override {}
+    void Deinitialize() override {}
+    void Dispatch(WPEFramework::Core::IDispatch* job) override
+    {
+        job->Dispatch();
+    }
+};
+
+bool waitFor(const std::function<bool()>& done, std::chrono::milliseconds timeout = std::chrono::seconds(10))
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (done() == false) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+class WorkStealingPoolTest : public ::testing::Test {
+protected:
+    Dispatcher dispatcher;
+};
+
+TEST_F(WorkStealingPoolTest, SubmitFromManyThreads)
+{
+    static constexpr uint32_t Producers = 4;
+    static constexpr uint32_t JobsEach = 5000;
+
+    WorkStealingPool pool(4, 0, &dispatcher, WorkStealingPool::Elasticity());
+    pool.Run();
+
+    std::atomic<uint32_t> ran { 0 };
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < Producers; ++p) {
+        producers.emplace_back([&pool, &ran]() {
+            for (uint32_t i = 0; i < JobsEach; ++i) {
+                pool.Submit(task([&ran]() { ++ran; }));
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(waitFor([&ran]() { return ran == Producers * JobsEach; }));
+    pool.Stop();
+}
+
+// Follow-up jobs stay on the deque of the worker submitting them; as that worker stays
+// busy until they are all done, they can only complete by being stolen
+TEST_F(WorkStealingPoolTest, IdleWorkersSteal)
+{
+    static constexpr uint32_t FollowUps = 100;
+
+    WorkStealingPool pool(4, 0, &dispatcher, WorkStealingPool::Elasticity());
+    pool.Run();
+
+    std::atomic<uint32_t> ran { 0 };
+    std::atomic<bool> parentDone { false };
+    std::thread::id parent;
+    std::mutex threadsLock;
+    std::set<std::thread::id> threads;
+    pool.Submit(task([&]() {
+        parent = std::this_thread::get_id();
+        for (uint32_t i = 0; i < FollowUps; ++i) {
+            pool.Submit(task([&]() {
+                {
+                    std::lock_guard<std::mutex> lock(threadsLock);
+                    threads.insert(std::this_thread::get_id());
+                }
+                ++ran;
+            }));
+        }
+        parentDone = waitFor([&ran]() { return ran == FollowUps; });
+    }));
+
+    EXPECT_TRUE(waitFor([&parentDone]() { return parentDone.load(); }));
+    EXPECT_EQ(ran, FollowUps);
+    EXPECT_EQ(threads.count(parent), 0u);
+    pool.Stop();
+}
+
+TEST_F(WorkStealingPoolTest, RevokeQueuedJob)
+{
+    WorkStealingPool pool(1, 0, &dispatcher, WorkStealingPool::Elasticity());
+    pool.Run();
+
+    std::atomic<bool> release { false };
+    std::atomic<bool> blocking { false };
+    std::atomic<bool> revokedRan { false };
+    pool.Submit(task([&]() {
+        blocking = true;
+        waitFor([&release]() { return release.load(); });
+    }));
+    ASSERT_TRUE(waitFor([&blocking]() { return blocking.load(); }));
+
+    Job queued = task([&revokedRan]() { revokedRan = true; });
+    pool.Submit(queued);
+    EXPECT_EQ(pool.Revoke(queued, 0), WPEFramework::Core::ERROR_NONE);
+    EXPECT_EQ(pool.Revoke(queued, 0), WPEFramework::Core::ERROR_UNKNOWN_KEY);
+
+    release = true;
+    std::atomic<bool> after { false };
+    pool.Submit(task([&after]() { after = true; }));
+    EXPECT_TRUE(waitFor([&after]() { return after.load(); }));
+    EXPECT_FALSE(revokedRan);
+    pool.Stop();
+}
+
+TEST_F(WorkStealingPoolTest, RevokeWaitsForRunningJob)
+{
+    WorkStealingPool pool(2, 0, &dispatcher, WorkStealingPool::Elasticity());
+    pool.Run();
+
+    std::atomic<bool> started { false };
+    std::atomic<bool> finished { false };
+    Job running = task([&]() {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        finished = true;
+    });
+    pool.Submit(running);
+    ASSERT_TRUE(waitFor([&started]() { return started.load(); }));
+
+    EXPECT_EQ(pool.Revoke(running, 10), WPEFramework::Core::ERROR_TIMEDOUT);
+    EXPECT_EQ(pool.Revoke(running, WPEFramework::Core::infinite), WPEFramework::Core::ERROR_NONE);
+    EXPECT_TRUE(finished);
+    pool.Stop();
+}
+
+TEST_F(WorkStealingPoolTest, RevokeFromItsOwnJob)
+{
+    WorkStealingPool pool(1, 0, &dispatcher, WorkStealingPool::Elasticity());
+    pool.Run();
+
+    std::atomic<uint32_t> result { WPEFramework::Core::ERROR_GENERAL };
+    std::atomic<bool> done { false };
+    Job self;
+    self = task([&]() {
+        result = pool.Revoke(self, WPEFramework::Core::infinite);
+        done = true;
+    });
+    pool.Submit(self);
+    EXPECT_TRUE(waitFor([&done]() { return done.load(); }));
+    EXPECT_EQ(result, WPEFramework::Core::ERROR_UNKNOWN_KEY);
+    self = Job();
+    pool.Stop();
+}
+
+// Whatever Revoke() returns, the job is not running anymore and does not run later
+TEST_F(WorkStealingPoolTest, SubmitAndRevokeConcurrently)
+{
+    static constexpr uint32_t Threads = 4;
+    static constexpr uint32_t JobsEach = 2000;
+
+    WorkStealingPool pool(4, 0, &dispatcher, WorkStealingPool::Elasticity());
+    pool.Run();
+
+    std::atomic<uint32_t> ranAfterRevoke { 0 };
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < Threads; ++t) {
+        threads.emplace_back([&pool, &ranAfterRevoke]() {
+            for (uint32_t i = 0; i < JobsEach; ++i) {
+                auto revoked = std::make_shared<std::atomic<bool>>(false);
+                Job job = task([revoked, &ranAfterRevoke]() {
+                    if (revoked->load() == true) {
+                        ++ranAfterRevoke;
+                    }
+                });
+                pool.Submit(job);
+                pool.Revoke(job, WPEFramework::Core::infinite);
+                revoked->store(true);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Nothing is left pending, the pool goes on taking jobs
+    std::atomic<bool> after { false };
+    pool.Submit(task([&after]() { after = true; }));
+    EXPECT_TRUE(waitFor([&after]() { return after.load(); }));
+    EXPECT_EQ(ranAfterRevoke, 0u);
+    pool.Stop();
+}
+
+TEST_F(WorkStealingPoolTest, GrowsWhileJobsWait)
+{
+    WorkStealingPool::Elasticity elasticity;
+    elasticity.MaxThreads = 4;
+    elasticity.SpawnThreshold = 10;
+    elasticity.IdleTimeout = 50;
+    WorkStealingPool pool(1, 0, &dispatcher, elasticity);
+    pool.Run();
+
+    std::atomic<bool> release { false };
+    std::atomic<uint32_t> ran { 0 };
+    pool.Submit(task([&release]() { waitFor([&release]() { return release.load(); }); }));
+    pool.Submit(task([&ran]() { ++ran; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    pool.Submit(task([&ran]() { ++ran; }));
+
+    EXPECT_TRUE(waitFor([&ran]() { return ran == 2; }));
+    EXPECT_GE(pool.Size().Spawned, 1u);
+
+    release = true;
+    // Back to the initial thread once the extra ones went idle
+    EXPECT_TRUE(waitFor([&pool]() { return pool.Size().Current == 1; }));
+    pool.Stop();
+}
+
+// Stopping lets the workers go, running again brings as many back
+TEST_F(WorkStealingPoolTest, RunAgainAfterStop)
+{
+    WorkStealingPool pool(2, 0, &dispatcher, WorkStealingPool::Elasticity());
+    pool.Run();
+    EXPECT_EQ(pool.Size().Current, 2u);
+    pool.Stop();
+    EXPECT_EQ(pool.Size().Current, 0u);
+
+    pool.Run();
+    EXPECT_EQ(pool.Size().Current, 2u);
+    std::atomic<uint32_t> ran { 0 };
+    for (uint32_t i = 0; i < 100; ++i) {
+        pool.Submit(task([&ran]() { ++ran; }));
+    }
+    EXPECT_TRUE(waitFor([&ran]() { return ran == 100; }));
+    pool.Stop();
+}
+
+// Growing and shrinking are not limited to the first Run()
+TEST_F(WorkStealingPoolTest, ElasticAcrossRuns)
+{
+    WorkStealingPool::Elasticity elasticity;
+    elasticity.MaxThreads = 2;
+    elasticity.SpawnThreshold = 10;
+    elasticity.IdleTimeout = 50;
+    WorkStealingPool pool(1, 0, &dispatcher, elasticity);
+
+    for (uint32_t run = 1; run <= 2; ++run) {
+        pool.Run();
+        std::atomic<bool> release { false };
+        std::atomic<bool> ran { false };
+        pool.Submit(task([&release]() { waitFor([&release]() { return release.load(); }); }));
+        pool.Submit(task([&ran]() { ran = true; }));
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        pool.Submit(task([]() {}));
+
+        EXPECT_TRUE(waitFor([&ran]() { return ran.load(); }));
+        EXPECT_EQ(pool.Size().Spawned, run);
+        release = true;
+        EXPECT_TRUE(waitFor([&pool]() { return pool.Size().Current == 1; }));
+        EXPECT_EQ(pool.Size().Retired, run);
+        pool.Stop();
+        EXPECT_EQ(pool.Size().Current, 0u);
+    }
+}
+
+// Plain jobs count in the queue depth as tracked ones do
+TEST(WorkerPoolStatisticsTest, QueueDepthCountsAllJobs)
+{
+    WorkerPoolImplementation pool(1, WPEFramework::Core::Thread::DefaultStackSize(), 8, WorkerPoolImplementation::Scheduler::WorkStealing);
+    pool.Run();
+
+    std::atomic<bool> release { false };
+    std::atomic<bool> blocking { false };
+    std::atomic<uint32_t> ran { 0 };
+    pool.Submit(task([&]() {
+        blocking = true;
+        waitFor([&release]() { return release.load(); });
+    }));
+    ASSERT_TRUE(waitFor([&blocking]() { return blocking.load(); }));
+    EXPECT_EQ(pool.Statistics().QueueDepth, 0u);
+
+    std::vector<Job> queued;
+    for (uint32_t i = 0; i < 3; ++i) {
+        queued.push_back(task([&ran]() { ++ran; }));
+        pool.Submit(queued.back());
+    }
+    EXPECT_EQ(pool.Statistics().QueueDepth, 3u);
+    EXPECT_EQ(pool.Revoke(queued.front(), 0), WPEFramework::Core::ERROR_NONE);
+    EXPECT_EQ(pool.Statistics().QueueDepth, 2u);
+
+    release = true;
+    EXPECT_TRUE(waitFor([&ran]() { return ran == 2; }));
+    WorkerPoolStatistics statistics = pool.Statistics();
+    EXPECT_EQ(statistics.QueueDepth, 0u);
+    EXPECT_EQ(statistics.QueueHighWater, 3u);
+
+    // A job revoked while it runs has left the queue already
+    std::atomic<bool> started { false };
+    Job running = task([&started]() {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    });
+    pool.Submit(running);
+    ASSERT_TRUE(waitFor([&started]() { return started.load(); }));
+    EXPECT_EQ(pool.Revoke(running, WPEFramework::Core::infinite), WPEFramework::Core::ERROR_NONE);
+    EXPECT_EQ(pool.Statistics().QueueDepth, 0u);
+    pool.Stop();
+}
+
+// Not a pass/fail test: reports how long each scheduler takes to run many short jobs
+// submitted from outside of the pool, as the socket thread does
+TEST(WorkerPoolBenchmark, SharedVersusWorkStealing)
+{
+    static constexpr uint32_t Producers = 2;
+    static constexpr uint32_t JobsEach = 50000;
+
+    for (WorkerPoolImplementation::Scheduler scheduler : { WorkerPoolImplementation::Scheduler::Shared, WorkerPoolImplementation::Scheduler::WorkStealing }) {
+        // The defaults of WorkerPoolConfig
+        WorkerPoolImplementation pool(3, WPEFramework::Core::Thread::DefaultStackSize(), 8, scheduler);
+        pool.Run();
+
+        std::atomic<uint32_t> ran { 0 };
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> producers;
+        for (uint32_t p = 0; p < Producers; ++p) {
+            producers.emplace_back([&pool, &ran]() {
+                for (uint32_t i = 0; i < JobsEach; ++i) {
+                    pool.Submit(task([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); }));
+                }
+            });
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        auto submitted = std::chrono::steady_clock::now();
+        EXPECT_TRUE(waitFor([&ran]() { return ran == Producers * JobsEach; }, std::chrono::seconds(60)));
+        auto done = std::chrono::steady_clock::now();
+        pool.Stop();
+
+        const char* name = (scheduler == WorkerPoolImplementation::Scheduler::Shared) ? "shared" : "workStealing";
+        auto ms = [](std::chrono::steady_clock::duration duration) {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+        };
+        std::cout << name << ": " << Producers * JobsEach << " jobs submitted in " << ms(submitted - start)
+                  << " ms, run in " << ms(done - start) << " ms" << std::endl;
+        RecordProperty(std::string(name) + "Ms", static_cast<int>(ms(done - start)));
+    }
+}
@@ -0,0 +1,298 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 Sky UK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Renders the binary log written by the Logger in Binary mode:
+//
+//     logdecode <log file> [<sites file>]
+//
+// The sites file defaults to '<log file>.sites'.
+
+#include "BinaryLogFormat.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <cinttypes>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace FireboltSDK::Transport;
+
+namespace {
+
+    struct Site {
+        std::string level;
+        std::string category;
+        std::string module;
+        std::string file;
+        std::string line;
+        std::string function;
+        std::string format;
+    };
+
+    std::string Unescape(const std::string& text)
+    {
+        std::string result;
+        for (size_t index = 0; index < text.size(); ++index) {
+            if ((text[index] == '\\') && ((index + 1) < text.size())) {
+                ++index;
+                result += (text[index] == 't') ? '\t' : (text[index] == 'n') ? '\n' : text[index];
+            } else {
+                result += text[index];
+            }
+        }
+        return result;
+    }
+
+    bool LoadSites(const std::string& path, std::unordered_map<uint32_t, Site>& sites)
+    {
+        std::ifstream input(path);
+        if (input.is_open() == false) {
+            return false;
+        }
+        std::string line;
+        while (std::getline(input, line)) {
+            std::vector<std::string> fields;
+            size_t start = 0;
+            // The format is last, it is the only field that could hold a tab, escaped
+            while (fields.size() < 7) {
+                size_t end = line.find('\t', start);
+                if (end == std::string::npos) {
+                    break;
+                }
+                fields.push_back(line.substr(start, end - start));
+                start = end + 1;
+            }
+            if (fields.size() == 7) {
+                sites[static_cast<uint32_t>(strtoul(fields[0].c_str(), nullptr, 10))] =
+                    { fields[1], fields[2], fields[3], fields[4], fields[5], fields[6], Unescape(line.substr(start)) };
+            }
+        }
+        return true;
+    }
+
+    // Walks the arguments of a record
+    class Arguments {
+    public:
+        Arguments(const uint8_t* data, const uint32_t size)
+            : _data(data)
+            , _size(size)
+            , _offset(0)
+        {
+        }
+
+        bool Next(BinaryLog::Tag& tag, uint64_t& value, double& real, std::string& text)
+        {
+            if (_offset >= _size) {
+                return false;
+            }
+            tag = static_cast<BinaryLog::Tag>(_data[_offset++]);
+            switch (tag) {
+            case BinaryLog::Tag::Signed:
+            case BinaryLog::Tag::Unsigned:
+            case BinaryLog::Tag::Pointer:
+                return Read(value);
+            case BinaryLog::Tag::Double:
+                return Read(real);
+            case BinaryLog::Tag::String: {
+                uint16_t length;
+                if ((Read(length) == false) || ((_offset + length) > _size)) {
+                    return false;
+                }
+                text.assign(reinterpret_cast<const char*>(&_data[_offset]), length);
+                _offset += length;
+                return true;
+            }
+            }
+            return false;
+        }
+
+    private:
+        template <typename TYPE>
+        bool Read(TYPE& value)
+        {
+            if ((_offset + sizeof(value)) > _size) {
+                return false;
+            }
+            memcpy(&value, &_data[_offset], sizeof(value));
+            _offset += sizeof(value);
+            return true;
+        }
+
+    private:
+        const uint8_t* _data;
+        uint32_t _size;
+        uint32_t _offset;
+    };
+
+    // Formats one conversion with the argument as it was stored, whatever the length
+    // modifier the format used
+    std::string Convert(std::string specification, const char conversion, Arguments& arguments)
+    {
+        BinaryLog::Tag tag;
+        uint64_t value = 0;
+        double real = 0;
+        std::string text;
+        char buffer[512];
+
+        // '*' widths and precisions were passed as arguments too
+        size_t star;
+        while ((star = specification.find('*')) != std::string::npos) {
+            if (arguments.Next(tag, value, real, text) == false) {
+                return "<missing>";
+            }
+            specification.replace(star, 1, std::to_string(static_cast<int64_t>(value)));
+        }
+        if (arguments.Next(tag, value, real, text) == false) {
+            return "<missing>";
+        }
+
+        switch (tag) {
+        case BinaryLog::Tag::Signed:
+        case BinaryLog::Tag::Unsigned:
+            if (strchr("diouxXc", conversion) != nullptr) {
+                if (conversion == 'c') {
+                    snprintf(buffer, sizeof(buffer), (specification + "c").c_str(), static_cast<int>(value));
+                } else if (tag == BinaryLog::Tag::Signed) {
+                    snprintf(buffer, sizeof(buffer), (specification + "ll" + conversion).c_str(), static_cast<long long>(value));
+                } else {
+                    snprintf(buffer, sizeof(buffer), (specification + "ll" + conversion).c_str(), static_cast<unsigned long long>(value));
+                }
+            } else {
+                snprintf(buffer, sizeof(buffer), "%" PRIu64, value);
+            }
+            break;
+        case BinaryLog::Tag::Double:
+            snprintf(buffer, sizeof(buffer), (specification + ((strchr("eEfFgGaA", conversion) != nullptr) ? conversion : 'g')).c_str(), real);
+            break;
+        case BinaryLog::Tag::String:
+            snprintf(buffer, sizeof(buffer), (specification + 's').c_str(), text.c_str());
+            break;
+        case BinaryLog::Tag::Pointer:
+            snprintf(buffer, sizeof(buffer), "%p", reinterpret_cast<void*>(static_cast<uintptr_t>(value)));
+            break;
+        }
+        return buffer;
+    }
+
+    std::string Render(const std::string& format, Arguments arguments)
+    {
+        std::string result;
+        for (size_t index = 0; index < format.size(); ++index) {
+            if (format[index] != '%') {
+                result += format[index];
+                continue;
+            }
+            if (((index + 1) < format.size()) && (format[index + 1] == '%')) {
+                result += '%';
+                ++index;
+                continue;
+            }
+            // Flags, width and precision are kept, the length modifiers dropped
+            std::string specification = "%";
+            size_t end = index + 1;
+            for (; (end < format.size()) && (strchr("diouxXeEfFgGaAcspn", format[end]) == nullptr); ++end) {
+                if (strchr("hljztLq", format[end]) == nullptr) {
+                    specification += format[end];
+                }
+            }
+            if (end == format.size()) {
+                result += format.substr(index);
+                break;
+            }
+            result += Convert(specification, format[end], arguments);
+            index = end;
+        }
+        return result;
+    }
+
+    std::string Time(const uint64_t ticks)
+    {
+        const time_t seconds = static_cast<time_t>(ticks / 1000000);
+        struct tm local;
+        char buffer[64];
+        gmtime_r(&seconds, &local);
+        size_t length = strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+        snprintf(buffer + length, sizeof(buffer) - length, ".%06u", static_cast<uint32_t>(ticks % 1000000));
+        return buffer;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if ((argc < 2) || (argc > 3)) {
+        fprintf(stderr, "Usage: %s <log file> [<sites file>]\n", argv[0]);
+        return 1;
+    }
+    const std::string logPath = argv[1];
+    const std::string sitesPath = (argc == 3) ? argv[2] : (logPath + ".sites");
+
+    std::unordered_map<uint32_t, Site> sites;
+    if (LoadSites(sitesPath, sites) == false) {
+        fprintf(stderr, "Cannot read %s\n", sitesPath.c_str());
+        return 1;
+    }
+
+    std::ifstream input(logPath, std::ios::binary);
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    BinaryLog::FileHeader header;
+    memset(&header, 0, sizeof(header));
+    if (content.size() >= sizeof(header)) {
+        memcpy(&header, content.data(), sizeof(header));
+    }
+    if ((memcmp(header.magic, BinaryLog::Magic, sizeof(header.magic)) != 0) || (header.capacity == 0) || ((content.size() - sizeof(header)) < header.capacity)) {
+        fprintf(stderr, "%s is not a binary log\n", logPath.c_str());
+        return 1;
+    }
+
+    const uint8_t* records = content.data() + sizeof(header);
+    const uint64_t capacity = header.capacity;
+    // The oldest records have been overwritten, the first one left may be cut as well
+    uint64_t offset = (header.head > capacity) ? (header.head - capacity) : 0;
+    while (offset < header.head) {
+        const uint64_t position = offset % capacity;
+        BinaryLog::RecordHeader record;
+        memset(&record, 0, sizeof(record));
+        memcpy(&record, records + position, std::min<uint64_t>(sizeof(record), capacity - position));
+
+        if ((record.magic != BinaryLog::RecordMagic) || (record.length < (2 * sizeof(uint32_t))) || ((record.length % BinaryLog::Alignment) != 0)
+            || ((position + record.length) > capacity)) {
+            // Not the start of a record, look for the next one
+            offset += BinaryLog::Alignment;
+            continue;
+        }
+        if ((record.length >= sizeof(record)) && (record.site != 0) && ((sizeof(record) + record.size) <= record.length)) {
+            auto site = sites.find(record.site);
+            if (site != sites.end()) {
+                const std::string message = Render(site->second.format, Arguments(records + position + sizeof(record), record.size));
+                printf("%s: [%s][%s]:[%s][%s:%s](%s)<PID:%u><TID:%" PRIu64 "> : %s\n", Time(record.time).c_str(), site->second.level.c_str(),
+                    site->second.category.c_str(), site->second.module.c_str(), site->second.file.c_str(), site->second.line.c_str(),
+                    site->second.function.c_str(), header.process, record.thread, message.c_str());
+            } else {
+                printf("%s: <unknown site %u>\n", Time(record.time).c_str(), record.site);
+            }
+        }
+        offset += record.length;
+    }
+    return 0;
+}